@@ -0,0 +1,656 @@
+// benchmark cases, compiled once per configuration (see cases_protected.cpp and
+// cases_baseline.cpp). everything goes through the public macros so the baseline
+// build measures exactly what the macros collapse to with CW_ENABLE_ALL=0.
+//
+// the includer defines CW_BENCH_TABLE to the case_table accessor it provides.
+
+#include "cw_bench.h"
+#include "synthetic_pe.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef CW_BENCH_TABLE
+    #error "define CW_BENCH_TABLE before including bench_cases.inl"
+#endif
+
+#define CW_BENCH_TEXT "benchmark string payload"
+#define CW_BENCH_WTEXT L"benchmark string payload"
+
+// stamps out distinct call sites. every copy is its own lambda with its own
+// function-local static, so each one pays the first-call decrypt
+#define CW_BENCH_X4(x) x x x x
+#define CW_BENCH_X16(x) CW_BENCH_X4(CW_BENCH_X4(x))
+#define CW_BENCH_X64(x) CW_BENCH_X4(CW_BENCH_X16(x))
+#define CW_BENCH_SITES 64
+
+// 1 KiB payload for the bulk decrypt path (128 cipher blocks per string)
+#define CW_BENCH_LONG_TEXT CW_BENCH_X16("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-_")
+#define CW_BENCH_LONG_SITES 16
+
+#if CW_ENABLE_CONTROL_FLOW
+    #define CW_BENCH_PRED(fn, ...) (cloakwork::control_flow::opaque_detail::fn(__VA_ARGS__))
+#else
+    #define CW_BENCH_PRED(fn, ...) (cw_bench::g_seed != 0u || true)
+#endif
+
+namespace {
+    using namespace cw_bench;
+
+    inline uint64_t touch(const char* s) {
+        do_not_optimize(s);
+        return static_cast<uint8_t>(s[0]) + static_cast<uint8_t>(s[sizeof(CW_BENCH_TEXT) - 2]);
+    }
+
+    inline uint64_t touch(const wchar_t* s) {
+        do_not_optimize(s);
+        return static_cast<uint64_t>(s[0]) + static_cast<uint64_t>(s[sizeof(CW_BENCH_TEXT) - 2]);
+    }
+
+    inline uint64_t touch_long(const char* s) {
+        do_not_optimize(s);
+        return static_cast<uint8_t>(s[0]) + static_cast<uint8_t>(s[sizeof(CW_BENCH_LONG_TEXT) - 2]);
+    }
+
+    // ---------------------------------------------------------------- strings
+
+    uint64_t str_first(uint64_t) {
+        uint64_t sum = 0;
+        CW_BENCH_X64(sum += touch(CW_STR(CW_BENCH_TEXT));)
+        return sum;
+    }
+
+    uint64_t str_steady(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i)
+            sum += touch(CW_STR(CW_BENCH_TEXT));
+        return sum;
+    }
+
+    // 64 sites, one literal: one ciphertext and one decrypt for all of them
+    uint64_t shared_first(uint64_t) {
+        uint64_t sum = 0;
+        CW_BENCH_X64(sum += touch(CW_STR_SHARED(CW_BENCH_TEXT));)
+        return sum;
+    }
+
+    uint64_t sv_steady(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            std::string_view v = CW_SV(CW_BENCH_TEXT);
+            do_not_optimize(v.data());
+            sum += v.size() + static_cast<uint8_t>(v.back());
+        }
+        return sum;
+    }
+
+    // runtime inputs for the comparison cases: equal, same length with the
+    // first byte off, and a different length
+    char eq_match[] = CW_BENCH_TEXT;
+    char eq_miss[] = "Benchmark string payload";
+    char eq_short[] = "benchmark";
+
+    template<const char* Input>
+    uint64_t str_eq(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const char* in = Input;
+            do_not_optimize(in);
+            sum += CW_STR_EQ(std::string_view(in, sizeof(CW_BENCH_TEXT) - 1), CW_BENCH_TEXT);
+        }
+        return sum;
+    }
+
+    uint64_t str_eq_short(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const char* in = eq_short;
+            do_not_optimize(in);
+            sum += CW_STR_EQ(std::string_view(in, sizeof(eq_short) - 1), CW_BENCH_TEXT);
+        }
+        return sum;
+    }
+
+    uint64_t str_eq_ct(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const char* in = eq_miss;
+            do_not_optimize(in);
+            sum += CW_STR_EQ_CT(std::string_view(in, sizeof(CW_BENCH_TEXT) - 1), CW_BENCH_TEXT);
+        }
+        return sum;
+    }
+
+    uint64_t str_long_first(uint64_t) {
+        uint64_t sum = 0;
+        CW_BENCH_X16(sum += touch_long(CW_STR(CW_BENCH_LONG_TEXT));)
+        return sum;
+    }
+
+    uint64_t layered_first(uint64_t) {
+        uint64_t sum = 0;
+        CW_BENCH_X64(sum += touch(CW_STR_LAYERED(CW_BENCH_TEXT));)
+        return sum;
+    }
+
+    uint64_t layered_steady(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i)
+            sum += touch(CW_STR_LAYERED(CW_BENCH_TEXT));
+        return sum;
+    }
+
+    uint64_t wstr_first(uint64_t) {
+        uint64_t sum = 0;
+        CW_BENCH_X64(sum += touch(CW_WSTR(CW_BENCH_WTEXT));)
+        return sum;
+    }
+
+    uint64_t wstr_steady(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i)
+            sum += touch(CW_WSTR(CW_BENCH_WTEXT));
+        return sum;
+    }
+
+    uint64_t stack_first(uint64_t) {
+        uint64_t sum = 0;
+        CW_BENCH_X64({ auto s = CW_STR_STACK(CW_BENCH_TEXT); sum += touch(static_cast<const char*>(s)); })
+        return sum;
+    }
+
+    uint64_t stack_steady(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            auto s = CW_STR_STACK(CW_BENCH_TEXT);
+            sum += touch(static_cast<const char*>(s));
+        }
+        return sum;
+    }
+
+    uint64_t with_decrypted_steady(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i)
+            sum += CW_WITH_DECRYPTED(CW_BENCH_TEXT, [](std::string_view v) { return touch(v.data()); });
+        return sum;
+    }
+
+    // 64 KiB asset for the chunked blob path (16 chunks at the default size)
+    constexpr std::array<uint8_t, 65536> make_blob_data() {
+        std::array<uint8_t, 65536> out{};
+        uint32_t x = 0x9E3779B9u;
+        for (size_t i = 0; i < out.size(); ++i) {
+            x = x * 1664525u + 1013904223u;
+            out[i] = static_cast<uint8_t>(x >> 24);
+        }
+        return out;
+    }
+
+    constexpr auto blob_data = make_blob_data();
+
+    uint64_t blob_stream(uint64_t iters) {
+        static uint8_t buf[CW_BLOB_CHUNK_SIZE];
+        auto blob = CW_BLOB(blob_data);
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            blob.for_each_chunk(buf, [&](const uint8_t* p, size_t n) {
+                do_not_optimize(p);
+                sum += p[n - 1];
+            });
+        }
+        return sum;
+    }
+
+    // ---------------------------------------------------------------- logging
+
+    // hot-path cost of one CW_LOG call; the ring is drained to a null sink
+    // every 1024 calls so it never fills and drops
+    uint64_t log_two_args(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            CW_LOG(info, "request {} took {} us", i, g_seed);
+            if ((i & 1023) == 1023)
+                sum += cloakwork::logging::drain([](const uint8_t*, size_t) {});
+        }
+        return sum + cloakwork::logging::drain([](const uint8_t*, size_t) {});
+    }
+
+    // ---------------------------------------------------------------- threads
+
+    // splits iters across Threads copies of a steady-state case that all hit the
+    // same site; the driver divides wall time by iters, so this is ns per read
+    // at that thread count (lower is better, flat means it scales)
+    template<unsigned Threads>
+    uint64_t across_threads(uint64_t iters, case_fn body) {
+        std::atomic<uint64_t> total{0};
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < Threads; ++t)
+            pool.emplace_back([&] { total += body(iters / Threads); });
+        for (auto& th : pool) th.join();
+        return total.load();
+    }
+
+    uint64_t str_mt(uint64_t iters)     { return across_threads<4>(iters, str_steady); }
+    uint64_t layered_mt(uint64_t iters) { return across_threads<4>(iters, layered_steady); }
+
+    // ----------------------------------------------------------------- values
+
+    uint64_t int_get(uint64_t iters) {
+        auto v = CW_INT(static_cast<uint32_t>(g_seed));
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            do_not_optimize(v);
+            sum += static_cast<uint32_t>(v);
+        }
+        return sum;
+    }
+
+    uint64_t int_set(uint64_t iters) {
+        auto v = CW_INT(static_cast<uint32_t>(g_seed));
+        for (uint64_t i = 0; i < iters; ++i) {
+            v = static_cast<uint32_t>(i);
+            do_not_optimize(v);
+        }
+        return static_cast<uint32_t>(v);
+    }
+
+    uint64_t mba_get(uint64_t iters) {
+        auto v = CW_MBA(static_cast<uint32_t>(g_seed));
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            do_not_optimize(v);
+            sum += static_cast<uint32_t>(v);
+        }
+        return sum;
+    }
+
+    uint64_t op_add(uint64_t iters) {
+        uint32_t a = g_seed, b = g_seed ^ 0x9E3779B9u;
+        for (uint64_t i = 0; i < iters; ++i) {
+            a = CW_ADD(a, b);
+            do_not_optimize(a);
+        }
+        return a;
+    }
+
+    uint64_t op_sub(uint64_t iters) {
+        uint32_t a = g_seed, b = g_seed ^ 0x9E3779B9u;
+        for (uint64_t i = 0; i < iters; ++i) {
+            a = CW_SUB(a, b);
+            do_not_optimize(a);
+        }
+        return a;
+    }
+
+    uint64_t op_neg(uint64_t iters) {
+        int32_t a = static_cast<int32_t>(g_seed);
+        for (uint64_t i = 0; i < iters; ++i) {
+            a = CW_NEG(a);
+            do_not_optimize(a);
+        }
+        return static_cast<uint32_t>(a);
+    }
+
+    uint64_t op_eq(uint64_t iters) {
+        uint32_t a = g_seed, b = g_seed + 7u;
+        uint64_t hits = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            hits += CW_EQ(a, b) ? 1u : 0u;
+            ++a;
+            do_not_optimize(a);
+        }
+        return hits;
+    }
+
+    uint64_t op_lt(uint64_t iters) {
+        uint32_t a = g_seed, b = g_seed + 0x8000u;
+        uint64_t hits = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            hits += CW_LT(a, b) ? 1u : 0u;
+            ++a;
+            do_not_optimize(a);
+        }
+        return hits;
+    }
+
+    // ----------------------------------------------------------- control flow
+
+    template<int P>
+    uint64_t predicate(uint64_t iters) {
+        uint64_t hits = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            bool r;
+            if constexpr (P == 0) r = CW_BENCH_PRED(quadratic_residue_true, static_cast<uint32_t>(i));
+            else if constexpr (P == 1) r = CW_BENCH_PRED(consecutive_product_true);
+            else if constexpr (P == 2) r = CW_BENCH_PRED(gauss_sum_true);
+            else if constexpr (P == 3) r = CW_BENCH_PRED(popcount_complement_true);
+            else if constexpr (P == 4) r = CW_BENCH_PRED(crc_self_true);
+            else if constexpr (P == 5) r = CW_BENCH_PRED(bezout_true);
+            else if constexpr (P == 6) r = CW_BENCH_PRED(bit_decompose_true);
+            else r = CW_BENCH_PRED(modinv_true);
+            do_not_optimize(r);
+            hits += r;
+        }
+        return hits;
+    }
+
+    CW_NOINLINE uint32_t protected_body(uint32_t x) {
+        return CW_PROTECT(uint32_t, {
+            if (x & 1u) return x * 3u + 1u;
+            return x >> 1;
+        });
+    }
+
+    CW_NOINLINE uint32_t plain_body(uint32_t x) {
+        if (x & 1u) return x * 3u + 1u;
+        return x >> 1;
+    }
+
+    uint64_t cfg_protect(uint64_t iters) {
+        uint32_t x = g_seed | 1u;
+        for (uint64_t i = 0; i < iters; ++i)
+            x = protected_body(x) + 1u;
+        return x;
+    }
+
+    uint64_t cfg_flatten(uint64_t iters) {
+        uint32_t x = g_seed | 1u;
+        for (uint64_t i = 0; i < iters; ++i)
+            x = CW_FLATTEN(plain_body, x) + 1u;
+        return x;
+    }
+
+    // ---------------------------------------------------------------- hashing
+
+    // 256 command names "cmd_000".."cmd_255", looked up by runtime name the way
+    // a dispatch table would: hash the input, then find it among the keys
+    constexpr size_t hash_keys = 256;
+
+    struct cmd_names {
+        char name[hash_keys][8];
+        uint32_t hash[hash_keys];
+    };
+
+    consteval cmd_names make_cmd_names() {
+        cmd_names t{};
+        for (size_t i = 0; i < hash_keys; ++i) {
+            const char n[8] = { 'c', 'm', 'd', '_', char('0' + i / 100), char('0' + i / 10 % 10), char('0' + i % 10), 0 };
+            for (size_t j = 0; j < 8; ++j) t.name[i][j] = n[j];
+            t.hash[i] = cloakwork::hash::fnv1a(n, 7);
+        }
+        return t;
+    }
+
+    constexpr cmd_names cmds = make_cmd_names();
+    constexpr auto cmd_set = cloakwork::hash::make_hash_set(cmds.hash);
+
+    // the pre-CW_HASH_SET pattern: compare against every key in turn
+    uint64_t hash_linear(uint64_t iters) {
+        uint64_t sum = 0;
+        uint32_t pick = g_seed;
+        for (uint64_t i = 0; i < iters; ++i) {
+            pick = pick * 0x01000193u + 1u;
+            const char* in = cmds.name[pick % hash_keys];
+            CW_LAUNDER(in);
+            uint32_t h = cloakwork::hash::fnv1a_runtime(in);
+            for (auto k : cmds.hash)
+                if (k == h) { ++sum; break; }
+        }
+        return sum;
+    }
+
+    uint64_t hash_set_lookup(uint64_t iters) {
+        uint64_t sum = 0;
+        uint32_t pick = g_seed;
+        for (uint64_t i = 0; i < iters; ++i) {
+            pick = pick * 0x01000193u + 1u;
+            const char* in = cmds.name[pick % hash_keys];
+            CW_LAUNDER(in);
+            sum += cmd_set.contains(cloakwork::hash::fnv1a_runtime(in));
+        }
+        return sum;
+    }
+
+    // throughput of the two runtime hash families on a short export-style name
+    // and on 1 KiB, both through the NUL-terminated entry points
+    const char hash_short_input[] = "NtQueryInformationProcess";
+    const char hash_long_input[] = CW_BENCH_LONG_TEXT;
+
+    template<const char* Input>
+    uint64_t hash_fnv1a(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const char* in = Input;
+            CW_LAUNDER(in);
+            sum += cloakwork::hash::fnv1a_runtime(in);
+        }
+        return sum;
+    }
+
+    // same as hash_fnv1a but with the length known, as with UNICODE_STRING
+    template<const char* Input>
+    uint64_t hash_fnv1a_counted(uint64_t iters) {
+        constexpr size_t len = std::char_traits<char>::length(Input);
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const char* in = Input;
+            CW_LAUNDER(in);
+            sum += cloakwork::hash::fnv1a_runtime(in, len);
+        }
+        return sum;
+    }
+
+    template<const char* Input>
+    uint64_t hash_64(uint64_t iters) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const char* in = Input;
+            CW_LAUNDER(in);
+            sum += cloakwork::hash::hash64_runtime(in);
+        }
+        return sum;
+    }
+
+    // ---------------------------------------------------------------- imports
+
+    // lookups by name hash in a 2500-export image (about ntdll's size). the scan
+    // is pe::find_export, what walkExportTable falls back to without an index
+    struct export_lookup {
+        cloakwork::pe::image_view img;
+        std::vector<uint32_t> hashes;
+    };
+
+    const export_lookup& export_fixture() {
+        static const export_lookup fx = [] {
+            export_lookup f;
+            const synthetic_pe& pe = ntdll_sized_pe();
+            f.img.parse(pe.mapped.data(), pe.mapped.size());
+            for (auto& n : pe.names) f.hashes.push_back(cloakwork::hash::fnv1a_runtime(n.c_str()));
+            return f;
+        }();
+        return fx;
+    }
+
+    uint64_t export_scan(uint64_t iters) {
+        const export_lookup& fx = export_fixture();
+        uint64_t sum = 0;
+        uint32_t pick = g_seed;
+        for (uint64_t i = 0; i < iters; ++i) {
+            pick = pick * 0x01000193u + 1u;
+            sum += cloakwork::pe::find_export(fx.img, fx.hashes[pick % fx.hashes.size()]);
+        }
+        return sum;
+    }
+
+    uint64_t export_index_find(uint64_t iters) {
+        const export_lookup& fx = export_fixture();
+        static const cloakwork::pe::export_index index = [&] {
+            cloakwork::pe::export_index x;
+            x.build(fx.img);
+            return x;
+        }();
+        uint64_t sum = 0;
+        uint32_t pick = g_seed;
+        for (uint64_t i = 0; i < iters; ++i) {
+            pick = pick * 0x01000193u + 1u;
+            uint32_t h = fx.hashes[pick % fx.hashes.size()];
+            CW_LAUNDER(h);
+            sum += index.find(h);
+        }
+        return sum;
+    }
+
+    // the one-time cost per module, from the on-disk layout
+    uint64_t export_index_build(uint64_t iters) {
+        const synthetic_pe& pe = ntdll_sized_pe();
+        cloakwork::pe::image_view img;
+        img.parse(pe.file.data(), pe.file.size(), cloakwork::pe::layout::file);
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            cloakwork::pe::export_index index;
+            index.build(img);
+            sum += index.size();
+        }
+        return sum;
+    }
+
+    // offline tooling: parse a file-layout image and visit every section and
+    // named export, as cw_pedump does on an mmap'd file
+    uint64_t pe_walk_file(uint64_t iters) {
+        const synthetic_pe& pe = ntdll_sized_pe();
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            const uint8_t* data = pe.file.data();
+            CW_LAUNDER(data);
+            cloakwork::pe::image_view img;
+            img.parse(data, pe.file.size(), cloakwork::pe::layout::file);
+            for (const cloakwork::pe::section& sec : img.sections()) sum += sec.raw_size;
+            for (const cloakwork::pe::export_symbol& sym : img.exports()) sum += sym.rva + sym.forwarded;
+        }
+        return sum;
+    }
+
+    // startup: 60 imports from one module, spread over the name table. per-site
+    // resolution is 60 scans; CW_IMPORT_SET is one pass with a perfect-hash probe
+    constexpr size_t startup_imports = 60;
+
+    consteval cloakwork::pe::export_names<startup_imports> startup_names() {
+        cloakwork::pe::export_names<startup_imports> out{};
+        for (size_t k = 0; k < startup_imports; ++k) {
+            synthetic_name n = synthetic_export_name(k * 41 + 7, ntdll_export_count);
+            out.hashes[k] = cloakwork::hash::fnv1a(n.text, n.len);
+        }
+        return out;
+    }
+
+    constexpr auto startup_set = startup_names();
+
+    uint64_t startup_per_site(uint64_t iters) {
+        const export_lookup& fx = export_fixture();
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i)
+            for (uint32_t h : startup_set.hashes)
+                sum += cloakwork::pe::find_export(fx.img, h);
+        return sum;
+    }
+
+    uint64_t startup_import_set(uint64_t iters) {
+        static constexpr auto wanted = cloakwork::pe::export_name_positions(startup_set);
+        const export_lookup& fx = export_fixture();
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            uint32_t rvas[startup_imports];
+            sum += cloakwork::pe::resolve_exports(fx.img, wanted, rvas);
+            sum += rvas[startup_imports - 1];
+        }
+        return sum;
+    }
+
+    // ------------------------------------------------------------------- misc
+
+    uint64_t scatter_get(uint64_t iters) {
+        cloakwork::data_hiding::scattered_value<uint64_t> v(static_cast<uint64_t>(g_seed));
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            do_not_optimize(v);
+            sum += v.get();
+        }
+        return sum;
+    }
+
+    CW_NOINLINE uint32_t call_target(uint32_t x) {
+        return x * 0x01000193u + 1u;
+    }
+
+    uint64_t call_obf(uint64_t iters) {
+        auto fn = CW_CALL(call_target);
+        uint32_t x = g_seed;
+        for (uint64_t i = 0; i < iters; ++i) {
+            x = fn(x);
+            do_not_optimize(x);
+        }
+        return x;
+    }
+
+    const bench_case cases[] = {
+        { "strings",      "CW_STR first call",         str_first,      CW_BENCH_SITES },
+        { "strings",      "CW_STR steady state",       str_steady,     0 },
+        { "strings",      "CW_STR_SHARED first call",  shared_first,   CW_BENCH_SITES },
+        { "strings",      "CW_SV steady state",        sv_steady,      0 },
+        { "strings",      "CW_STR_EQ match",           str_eq<eq_match>, 0 },
+        { "strings",      "CW_STR_EQ first-byte miss", str_eq<eq_miss>, 0 },
+        { "strings",      "CW_STR_EQ length miss",     str_eq_short,   0 },
+        { "strings",      "CW_STR_EQ_CT miss",         str_eq_ct,      0 },
+        { "strings",      "CW_STR 1 KiB first call",   str_long_first, CW_BENCH_LONG_SITES },
+        { "strings",      "CW_STR_LAYERED first call", layered_first,  CW_BENCH_SITES },
+        { "strings",      "CW_STR_LAYERED steady",     layered_steady, 0 },
+        { "strings",      "CW_WSTR first call",        wstr_first,     CW_BENCH_SITES },
+        { "strings",      "CW_WSTR steady state",      wstr_steady,    0 },
+        { "strings",      "CW_STR_STACK first call",   stack_first,    CW_BENCH_SITES },
+        { "strings",      "CW_STR_STACK steady state", stack_steady,   0 },
+        { "strings",      "CW_WITH_DECRYPTED",         with_decrypted_steady, 0 },
+        { "strings",      "CW_BLOB 64 KiB stream",     blob_stream,    0 },
+        { "logging",      "CW_LOG 2 args",             log_two_args,   0, true },
+        { "hashing",      "linear scan, 256 keys",     hash_linear,    0, true },
+        { "hashing",      "CW_HASH_SET, 256 keys",     hash_set_lookup, 0, true },
+        { "hashing",      "fnv1a_runtime, 25 B",       hash_fnv1a<hash_short_input>, 0, true },
+        { "hashing",      "fnv1a_runtime counted, 25 B", hash_fnv1a_counted<hash_short_input>, 0, true },
+        { "hashing",      "hash64_runtime, 25 B",      hash_64<hash_short_input>, 0, true },
+        { "hashing",      "fnv1a_runtime, 1 KiB",      hash_fnv1a<hash_long_input>, 0, true },
+        { "hashing",      "hash64_runtime, 1 KiB",     hash_64<hash_long_input>, 0, true },
+        { "imports",      "export scan, 2500 names",   export_scan,    0, true },
+        { "imports",      "export_index find",         export_index_find, 0, true },
+        { "imports",      "export_index build, 2500",  export_index_build, 0, true },
+        { "imports",      "image_view walk, file 2500", pe_walk_file,  0, true },
+        { "imports",      "startup, 60 per-site scans", startup_per_site, 0, true },
+        { "imports",      "startup, CW_IMPORT_SET of 60", startup_import_set, 0, true },
+        { "threads",      "CW_STR steady, 4 threads",  str_mt,         0 },
+        { "threads",      "CW_STR_LAYERED, 4 threads", layered_mt,     0 },
+        { "values",       "CW_INT get",                int_get,        0 },
+        { "values",       "CW_INT set",                int_set,        0 },
+        { "values",       "CW_MBA get",                mba_get,        0 },
+        { "values",       "CW_ADD",                    op_add,         0 },
+        { "values",       "CW_SUB",                    op_sub,         0 },
+        { "values",       "CW_NEG",                    op_neg,         0 },
+        { "values",       "CW_EQ",                     op_eq,          0 },
+        { "values",       "CW_LT",                     op_lt,          0 },
+        { "control flow", "quadratic_residue_true",    predicate<0>,   0 },
+        { "control flow", "consecutive_product_true",  predicate<1>,   0 },
+        { "control flow", "gauss_sum_true",            predicate<2>,   0 },
+        { "control flow", "popcount_complement_true",  predicate<3>,   0 },
+        { "control flow", "crc_self_true",             predicate<4>,   0 },
+        { "control flow", "bezout_true",               predicate<5>,   0 },
+        { "control flow", "bit_decompose_true",        predicate<6>,   0 },
+        { "control flow", "modinv_true",               predicate<7>,   0 },
+        { "control flow", "CW_PROTECT dispatch",       cfg_protect,    0 },
+        { "control flow", "CW_FLATTEN dispatch",       cfg_flatten,    0 },
+        { "misc",         "scattered_value::get",      scatter_get,    0 },
+        { "misc",         "obfuscated_call::operator()", call_obf,     0 },
+    };
+}
+
+cw_bench::case_table cw_bench::CW_BENCH_TABLE() {
+    return { cases, sizeof(cases) / sizeof(cases[0]) };
+}
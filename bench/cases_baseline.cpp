@@ -0,0 +1,10 @@
+// cw_bench cases with CW_ENABLE_ALL=0 - the plaintext baseline.
+// the namespace is renamed so this copy of the header doesn't collide with the
+// protected build under the one-definition rule when both are linked together.
+
+#define CW_ENABLE_ALL 0
+#define cloakwork cloakwork_baseline
+#include "cloakwork.h"
+
+#define CW_BENCH_TABLE baseline_cases
+#include "bench_cases.inl"
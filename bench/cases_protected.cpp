@@ -0,0 +1,6 @@
+// cw_bench cases with every cloakwork feature enabled (the defaults)
+
+#include "cloakwork.h"
+
+#define CW_BENCH_TABLE protected_cases
+#include "bench_cases.inl"
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+compile-time cost harness for cloakwork macros.
+
+generates one translation unit per (macro, site count) pair, compiles each with
+the chosen compiler and records wall time, peak compiler RSS, object size and
+template instantiation counts. the 'baseline' macro emits the same sites with no
+cloakwork macro at all; when it runs, ms/site is reported on top of it so the
+fixed cost of parsing the header drops out.
+
+usage:
+    python3 bench/compile_cost.py                          # every macro, 10/100/1000/10000 sites
+    python3 bench/compile_cost.py --macros CW_STR CW_PROTECT --sites 10 100
+    python3 bench/compile_cost.py --cxx clang++ --csv cost.csv --keep build-cost
+
+instantiation counts come from -ftime-trace when the compiler is clang. with gcc
+they are the number of distinct cloakwork template specializations emitted into
+the object (nm -C), which undercounts anything fully inlined or consteval.
+
+peak RSS needs os.wait4, so the harness runs on linux/macos only.
+"""
+
+import argparse
+import csv
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# per-site statement for each macro. {i} is the site index, used to make string
+# contents and constants distinct the way real code would be.
+MACROS = {
+    "baseline":       'sink("site {i} payload text");',
+    "CW_STR":         'sink(CW_STR("site {i} payload text"));',
+    "CW_STR_LAYERED": 'sink(CW_STR_LAYERED("site {i} payload text"));',
+    "CW_STR_STACK":   '{{ auto s = CW_STR_STACK("site {i} payload text"); sink(static_cast<const char*>(s)); }}',
+    "CW_WSTR":        'sinkw(CW_WSTR(L"site {i} payload text"));',
+    "CW_INT":         'sinki(static_cast<int>(CW_INT({i})));',
+    "CW_MBA":         'sinki(static_cast<int>(CW_MBA({i})));',
+    "CW_ADD":         'sinki(CW_ADD(x, {i}));',
+    "CW_TRUE":        'if (CW_TRUE) sinki({i});',
+    "CW_IF":          'CW_IF(x > {i}) {{ sinki({i}); }} CW_ELSE {{ sinki(-{i}); }}',
+    "CW_PROTECT":     'sinki(CW_PROTECT(int, {{ if (x > {i}) return x - {i}; return x + {i}; }}));',
+    "CW_CALL":        'sinki(CW_CALL(target)(x + {i}));',
+}
+
+DEFAULT_SITES = [10, 100, 1000, 10000]
+SITES_PER_FUNCTION = 50
+
+PRELUDE = """\
+#include "cloakwork.h"
+
+void sink(const char*);
+void sinkw(const wchar_t*);
+void sinki(int);
+int target(int);
+"""
+
+
+def generate(macro, sites):
+    stmt = MACROS[macro]
+    out = [PRELUDE]
+    for fn_start in range(0, sites, SITES_PER_FUNCTION):
+        out.append(f"void block_{fn_start}(int x) {{")
+        out.append("    (void)x;")
+        for i in range(fn_start, min(sites, fn_start + SITES_PER_FUNCTION)):
+            out.append("    " + stmt.format(i=i))
+        out.append("}")
+    return "\n".join(out) + "\n"
+
+
+def is_clang(cxx):
+    try:
+        ver = subprocess.run([cxx, "--version"], capture_output=True, text=True).stdout
+    except OSError:
+        return False
+    return "clang" in ver.lower()
+
+
+def run_compiler(cmd, timeout):
+    """runs cmd, returns (seconds, peak_rss_kib, returncode, stderr). rc None on timeout."""
+    # stderr goes to a file: a pipe fills up on warning-heavy TUs and stalls the compiler
+    with tempfile.TemporaryFile() as err_file:
+        start = time.perf_counter()
+        proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=err_file)
+        deadline = start + timeout
+        while True:
+            pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+            if pid != 0:
+                break
+            if time.perf_counter() > deadline:
+                proc.kill()
+                os.wait4(proc.pid, 0)
+                return time.perf_counter() - start, 0, None, ""
+            time.sleep(0.01)
+        elapsed = time.perf_counter() - start
+        err_file.seek(0)
+        stderr = err_file.read().decode(errors="replace")
+    rss = usage.ru_maxrss
+    if sys.platform == "darwin":
+        rss //= 1024  # bytes there, KiB on linux
+    return elapsed, rss, os.waitstatus_to_exitcode(status), stderr
+
+
+def count_trace_instantiations(trace_path):
+    with open(trace_path) as f:
+        events = json.load(f).get("traceEvents", [])
+    return sum(1 for e in events
+               if e.get("name") in ("InstantiateFunction", "InstantiateClass") and e.get("ph") == "X")
+
+
+def count_emitted_instantiations(obj_path):
+    nm = shutil.which("nm")
+    if not nm:
+        return None
+    out = subprocess.run([nm, "-C", obj_path], capture_output=True, text=True).stdout
+    symbols = set()
+    for line in out.splitlines():
+        name = line[line.find(" ", 17) + 1:] if len(line) > 19 else line
+        if "cloakwork::" in name and "<" in name:
+            symbols.add(name)
+    return len(symbols)
+
+
+def section_sizes(obj_path):
+    size = shutil.which("size")
+    if not size:
+        return None
+    out = subprocess.run([size, obj_path], capture_output=True, text=True).stdout.splitlines()
+    if len(out) < 2:
+        return None
+    fields = out[1].split()
+    try:
+        return int(fields[0]), int(fields[1]) + int(fields[2])
+    except (IndexError, ValueError):
+        return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    ap.add_argument("--flags", default="-std=c++20 -O2",
+                    help="compiler flags (default: %(default)s)")
+    ap.add_argument("--macros", nargs="+", default=list(MACROS), choices=list(MACROS))
+    ap.add_argument("--sites", nargs="+", type=int, default=DEFAULT_SITES)
+    ap.add_argument("--timeout", type=float, default=900.0, help="seconds per compile")
+    ap.add_argument("--csv", help="also write results to this csv file")
+    ap.add_argument("--keep", help="write generated sources/objects here instead of a temp dir")
+    args = ap.parse_args()
+
+    if not hasattr(os, "wait4"):
+        sys.exit("compile_cost.py needs os.wait4 (linux/macos)")
+
+    clang = is_clang(args.cxx)
+    workdir = args.keep or tempfile.mkdtemp(prefix="cw_cost_")
+    os.makedirs(workdir, exist_ok=True)
+
+    header = ["macro", "sites", "wall_s", "peak_rss_mib", "obj_kib", "text_kib", "data_kib",
+              "instantiations", "per_site_ms"]
+    rows = []
+    baseline_wall = {}
+
+    # baseline first so the per-site column can subtract the fixed header parse cost
+    macros = sorted(args.macros, key=lambda m: m != "baseline")
+    print(f"compiler: {args.cxx} ({'clang -ftime-trace' if clang else 'nm-counted'} instantiations)")
+    print(f"{'macro':<16}{'sites':>7}{'wall s':>10}{'rss MiB':>10}{'obj KiB':>10}"
+          f"{'text KiB':>10}{'inst':>8}{'ms/site':>10}")
+
+    for macro in macros:
+        for sites in args.sites:
+            stem = os.path.join(workdir, f"{macro.lower()}_{sites}")
+            src, obj = stem + ".cpp", stem + ".o"
+            with open(src, "w") as f:
+                f.write(generate(macro, sites))
+
+            cmd = [args.cxx, *args.flags.split(), "-I", REPO, "-c", src, "-o", obj]
+            if clang:
+                cmd.append("-ftime-trace")
+            wall, rss, rc, err = run_compiler(cmd, args.timeout)
+
+            if rc is None:
+                print(f"{macro:<16}{sites:>7}   timeout after {args.timeout:.0f}s")
+                rows.append([macro, sites, "timeout", "", "", "", "", "", ""])
+                continue
+            if rc != 0:
+                print(f"{macro:<16}{sites:>7}   compile failed (rc={rc})")
+                print("\n".join(err.splitlines()[:10]), file=sys.stderr)
+                rows.append([macro, sites, "failed", "", "", "", "", "", ""])
+                continue
+
+            obj_kib = os.path.getsize(obj) / 1024
+            secs = section_sizes(obj)
+            text_kib, data_kib = (secs[0] / 1024, secs[1] / 1024) if secs else (0.0, 0.0)
+            if clang and os.path.exists(stem + ".json"):
+                inst = count_trace_instantiations(stem + ".json")
+            else:
+                inst = count_emitted_instantiations(obj)
+            if macro == "baseline":
+                baseline_wall[sites] = wall
+            per_site = (wall - baseline_wall.get(sites, 0.0)) * 1000 / sites
+
+            print(f"{macro:<16}{sites:>7}{wall:>10.2f}{rss / 1024:>10.1f}{obj_kib:>10.1f}"
+                  f"{text_kib:>10.1f}{inst if inst is not None else '-':>8}{per_site:>10.2f}")
+            rows.append([macro, sites, f"{wall:.3f}", f"{rss / 1024:.1f}", f"{obj_kib:.1f}",
+                         f"{text_kib:.1f}", f"{data_kib:.1f}", inst if inst is not None else "",
+                         f"{per_site:.3f}"])
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            w = csv.writer(f)
+            w.writerow(header)
+            w.writerows(rows)
+
+    if not args.keep:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+// cw_bench - ns/op for cloakwork primitives against a CW_ENABLE_ALL=0 baseline.
+//
+// usage: cw_bench [--filter <substring>] [--min-time <ms>] [--reps <n>]
+//
+// every case is timed in both builds and reported with the overhead ratio
+// (protected / baseline). first-call cases run once over fresh call sites, so
+// they report the one-time decrypt cost per site rather than a steady state.
+// cases that build the same either way are timed once and show n/a.
+
+#include "cw_bench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+volatile uint32_t cw_bench::g_seed = 0x2545F491u;
+
+namespace {
+    using namespace cw_bench;
+    using clock_type = std::chrono::steady_clock;
+
+    struct options {
+        const char* filter = nullptr;
+        double min_time_ms = 100.0;
+        int reps = 5;
+    };
+
+    volatile uint64_t g_sink = 0;
+
+    double elapsed_ns(clock_type::time_point start) {
+        return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+    }
+
+    // best-of-reps ns/op. iteration count is grown until one run takes at
+    // least min_time / reps, then each rep runs that many iterations.
+    double measure(const bench_case& c, const options& opt) {
+        if (c.one_shot_ops) {
+            auto start = clock_type::now();
+            g_sink = g_sink + c.run(1);
+            return elapsed_ns(start) / static_cast<double>(c.one_shot_ops);
+        }
+
+        const double rep_ns = opt.min_time_ms * 1e6 / opt.reps;
+        uint64_t iters = 1;
+        for (;;) {
+            auto start = clock_type::now();
+            g_sink = g_sink + c.run(iters);
+            double ns = elapsed_ns(start);
+            if (ns >= rep_ns || iters >= (1ull << 40)) break;
+            uint64_t grow = ns > 0 ? static_cast<uint64_t>(rep_ns / ns * 1.2) + 1 : 16;
+            iters *= grow < 2 ? 2 : (grow > 16 ? 16 : grow);
+        }
+
+        double best = 0;
+        for (int r = 0; r < opt.reps; ++r) {
+            auto start = clock_type::now();
+            g_sink = g_sink + c.run(iters);
+            double per_op = elapsed_ns(start) / static_cast<double>(iters);
+            if (r == 0 || per_op < best) best = per_op;
+        }
+        return best;
+    }
+
+    const bench_case* find(const case_table& t, const bench_case& c) {
+        for (size_t i = 0; i < t.count; ++i) {
+            if (std::strcmp(t.cases[i].group, c.group) == 0 &&
+                std::strcmp(t.cases[i].name, c.name) == 0)
+                return &t.cases[i];
+        }
+        return nullptr;
+    }
+
+    bool parse(int argc, char** argv, options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+                opt.filter = argv[++i];
+            } else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+                opt.min_time_ms = std::atof(argv[++i]);
+            } else if (!std::strcmp(argv[i], "--reps") && i + 1 < argc) {
+                opt.reps = std::atoi(argv[++i]);
+            } else {
+                std::fprintf(stderr,
+                    "usage: %s [--filter <substring>] [--min-time <ms>] [--reps <n>]\n", argv[0]);
+                return false;
+            }
+        }
+        if (opt.reps < 1) opt.reps = 1;
+        if (opt.min_time_ms <= 0) opt.min_time_ms = 1;
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    options opt;
+    if (!parse(argc, argv, opt)) return 2;
+
+    const case_table prot = protected_cases();
+    const case_table base = baseline_cases();
+
+    std::printf("%-14s %-30s %14s %14s %10s\n",
+        "group", "case", "protected ns", "baseline ns", "overhead");
+
+    const char* last_group = "";
+    for (size_t i = 0; i < prot.count; ++i) {
+        const bench_case& c = prot.cases[i];
+        std::string label = std::string(c.group) + " " + c.name;
+        if (opt.filter && label.find(opt.filter) == std::string::npos) continue;
+
+        const bench_case* b = c.same_in_baseline ? nullptr : find(base, c);
+        double p_ns = measure(c, opt);
+        double b_ns = b ? measure(*b, opt) : 0.0;
+
+        if (std::strcmp(last_group, c.group) != 0) {
+            std::printf("\n");
+            last_group = c.group;
+        }
+
+        if (b && b_ns > 0.0)
+            std::printf("%-14s %-30s %14.2f %14.2f %9.1fx\n", c.group, c.name, p_ns, b_ns, p_ns / b_ns);
+        else
+            std::printf("%-14s %-30s %14.2f %14s %10s\n", c.group, c.name, p_ns, "-",
+                        c.same_in_baseline ? "n/a" : "-");
+    }
+
+    return 0;
+}
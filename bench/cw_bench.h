@@ -0,0 +1,49 @@
+// shared declarations for cw_bench.
+//
+// bench_cases.inl is compiled twice: once with cloakwork fully enabled and once
+// with CW_ENABLE_ALL=0 (the plaintext baseline). both builds register the same
+// case names so the driver can line them up and print an overhead ratio.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cw_bench {
+
+    // runs the case `iters` times and returns a checksum so the work can't be
+    // discarded. one-shot cases (first-call costs) ignore iters and do a single
+    // pass over `one_shot_ops` fresh call sites.
+    using case_fn = uint64_t(*)(uint64_t iters);
+
+    struct bench_case {
+        const char* group;
+        const char* name;
+        case_fn run;
+        uint64_t one_shot_ops;
+        // the case compiles to the same code with CW_ENABLE_ALL=0 (runtime
+        // hashing, PE walking, ...), so there is no baseline to compare with
+        bool same_in_baseline = false;
+    };
+
+    struct case_table {
+        const bench_case* cases;
+        size_t count;
+    };
+
+    case_table protected_cases();
+    case_table baseline_cases();
+
+    // runtime input the optimizer can't see through
+    extern volatile uint32_t g_seed;
+
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+}
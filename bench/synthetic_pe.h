@@ -0,0 +1,139 @@
+//
+// synthetic PE32+ images for the import-resolution cases. one .edata section
+// holds an export directory with `count` named exports, laid out the way the
+// linker does it (directory, function table, name table, ordinals, strings).
+// the image comes in both layouts: `mapped` as the loader would place it and
+// `file` as it would sit on disk, so cloakwork::pe can be pointed at either.
+//
+// nothing here touches cloakwork, so both bench configurations share it.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace cw_bench {
+
+    struct synthetic_pe {
+        std::vector<uint8_t> mapped;
+        std::vector<uint8_t> file;
+        std::vector<std::string> names;  // in export name table order
+    };
+
+    namespace synthetic_detail {
+        inline void put16(std::vector<uint8_t>& b, size_t at, uint16_t v) { memcpy(&b[at], &v, 2); }
+        inline void put32(std::vector<uint8_t>& b, size_t at, uint32_t v) { memcpy(&b[at], &v, 4); }
+    }
+
+    struct synthetic_name {
+        char text[32];
+        size_t len;
+    };
+
+    // ntdll-like names: a short prefix, a verb and a numbered noun. constexpr
+    // so cases can hash a chosen subset at compile time
+    constexpr synthetic_name synthetic_export_name(size_t i, size_t count) {
+        constexpr const char* prefixes[] = { "Csr", "Dbg", "Etw", "Ldr", "Nt", "Rtl", "Tp", "Zw" };
+        constexpr const char* verbs[] = { "Create", "Query", "Set", "Open", "Close", "Map" };
+        synthetic_name n{};
+        auto append = [&](const char* part) {
+            while (*part) n.text[n.len++] = *part++;
+        };
+        append(prefixes[i * 8 / count]);
+        append(verbs[i % 6]);
+        append("Object");
+        for (size_t div = 1000; div; div /= 10) n.text[n.len++] = static_cast<char>('0' + i / div % 10);
+        return n;
+    }
+
+    inline std::vector<std::string> synthetic_export_names(size_t count) {
+        std::vector<std::string> out;
+        out.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            synthetic_name n = synthetic_export_name(i, count);
+            out.emplace_back(n.text, n.len);
+        }
+        return out;
+    }
+
+    inline synthetic_pe make_synthetic_pe(const std::vector<std::string>& names) {
+        using namespace synthetic_detail;
+        constexpr uint32_t nt = 0x80;
+        constexpr uint32_t opt = nt + 24;
+        constexpr uint16_t opt_size = 240;
+        constexpr uint32_t section_header = opt + opt_size;
+        constexpr uint32_t headers_size = 0x400;
+        constexpr uint32_t section_va = 0x1000;
+
+        const uint32_t count = static_cast<uint32_t>(names.size());
+        const uint32_t functions = 40;
+        const uint32_t name_table = functions + count * 4;
+        const uint32_t ordinals = name_table + count * 4;
+        uint32_t strings = ordinals + count * 2;
+
+        std::vector<uint8_t> edata(strings);
+        put32(edata, 20, count);                         // NumberOfFunctions
+        put32(edata, 24, count);                         // NumberOfNames
+        put32(edata, 28, section_va + functions);        // AddressOfFunctions
+        put32(edata, 32, section_va + name_table);       // AddressOfNames
+        put32(edata, 36, section_va + ordinals);         // AddressOfNameOrdinals
+
+        uint32_t name_bytes = 0;
+        for (auto& n : names) name_bytes += static_cast<uint32_t>(n.size()) + 1;
+
+        // fake function bodies start on the page after the section
+        const uint32_t code_va = section_va + ((strings + name_bytes + 0xFFF) & ~0xFFFu);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            put32(edata, functions + i * 4, code_va + i * 16);
+            put32(edata, name_table + i * 4, section_va + strings);
+            put16(edata, ordinals + i * 2, static_cast<uint16_t>(i));
+            edata.insert(edata.end(), names[i].begin(), names[i].end());
+            edata.push_back(0);
+            strings += static_cast<uint32_t>(names[i].size()) + 1;
+        }
+
+        const uint32_t raw_size = (static_cast<uint32_t>(edata.size()) + 0x1FF) & ~0x1FFu;
+        const uint32_t image_size = code_va + count * 16;
+
+        std::vector<uint8_t> headers(headers_size);
+        put16(headers, 0, 0x5A4D);                       // MZ
+        put32(headers, 0x3C, nt);
+        put32(headers, nt, 0x4550);                      // PE\0\0
+        put16(headers, nt + 4, 0x8664);                  // AMD64
+        put16(headers, nt + 6, 1);                       // NumberOfSections
+        put16(headers, nt + 20, opt_size);
+        put16(headers, opt, 0x20B);                      // PE32+
+        put32(headers, opt + 56, image_size);
+        put32(headers, opt + 60, headers_size);
+        put32(headers, opt + 108, 16);                   // NumberOfRvaAndSizes
+        put32(headers, opt + 112, section_va);           // export directory
+        put32(headers, opt + 116, static_cast<uint32_t>(edata.size()));
+        memcpy(&headers[section_header], ".edata", 6);
+        put32(headers, section_header + 8, static_cast<uint32_t>(edata.size()));
+        put32(headers, section_header + 12, section_va);
+        put32(headers, section_header + 16, raw_size);
+        put32(headers, section_header + 20, headers_size);
+
+        synthetic_pe pe;
+        pe.names = names;
+        pe.mapped.assign(image_size, 0);
+        memcpy(pe.mapped.data(), headers.data(), headers.size());
+        memcpy(pe.mapped.data() + section_va, edata.data(), edata.size());
+        pe.file = headers;
+        pe.file.resize(headers_size + raw_size, 0);
+        memcpy(pe.file.data() + headers_size, edata.data(), edata.size());
+        return pe;
+    }
+
+    inline constexpr size_t ntdll_export_count = 2500;
+
+    // shared by every case, built on first use
+    inline const synthetic_pe& ntdll_sized_pe() {
+        static const synthetic_pe pe = make_synthetic_pe(synthetic_export_names(ntdll_export_count));
+        return pe;
+    }
+}
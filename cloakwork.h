@@ -94,6 +94,20 @@ Refer to the README.md for usage.
     #define CW_ENABLE_CONTROL_FLOW 0
 #endif
 
+#if !CW_KERNEL_MODE && !defined(_WIN32)
+    // PEB walking and export parsing need the windows loader structures
+    #ifdef CW_ENABLE_IMPORT_HIDING
+        #undef CW_ENABLE_IMPORT_HIDING
+    #endif
+    #define CW_ENABLE_IMPORT_HIDING 0
+
+    // direct syscalls resolve stubs out of ntdll
+    #ifdef CW_ENABLE_SYSCALLS
+        #undef CW_ENABLE_SYSCALLS
+    #endif
+    #define CW_ENABLE_SYSCALLS 0
+#endif
+
 #ifndef CW_ENABLE_ALL
     #define CW_ENABLE_ALL 1
 #endif
@@ -150,6 +164,47 @@ Refer to the README.md for usage.
     #define CW_ANTI_DEBUG_RESPONSE 1  // 0=ignore, 1=crash, 2=fake data
 #endif
 
+#ifndef CW_LAYERED_REKEY_INTERVAL
+    #define CW_LAYERED_REKEY_INTERVAL 10  // CW_STR_LAYERED accesses per thread between re-keys, 0=never
+#endif
+
+// CW_SHARED_STRING_SEED: CW_STR_SHARED key seed, the same in every TU. no default,
+// since a built-in value would give every build the same keys; CW_STR_SHARED
+// fails to compile until it is defined (the per-build CW_RANDOM_CT seed can't be
+// used, it differs between TUs)
+
+#ifndef CW_TRIVIAL_STRINGS
+    #define CW_TRIVIAL_STRINGS 0  // 1=string objects have no destructor; decrypted sites are wiped by wipe_all()
+#endif
+
+#ifndef CW_STR_ARENA_CHUNK
+    #define CW_STR_ARENA_CHUNK 16384  // bytes per plaintext arena chunk for CW_STR
+#endif
+
+// CW_LOG_KEY: CW_LOG manifest key, handed to the decoder with --key. no default,
+// since the shipped decoder would read any default build's logs; with string
+// encryption on, CW_LOG fails to compile until it is defined
+
+#ifndef CW_LOG_RING_SIZE
+    #define CW_LOG_RING_SIZE 65536  // bytes per thread ring for CW_LOG, power of two
+#endif
+
+#ifndef CW_LOG_MIN_LEVEL
+    #define CW_LOG_MIN_LEVEL 0  // CW_LOG sites below this level compile to nothing (0=trace .. 4=error)
+#endif
+
+#ifndef CW_EXPORT_INDEX_SLOTS
+    #define CW_EXPORT_INDEX_SLOTS 16  // modules whose export hash index is kept by the import resolver
+#endif
+
+#ifndef CW_BLOB_CHUNK_SIZE
+    #define CW_BLOB_CHUNK_SIZE 4096  // CW_BLOB bytes per chunk, multiple of 8
+#endif
+
+#ifndef CW_CIPHER_BACKEND
+    #define CW_CIPHER_BACKEND 0  // CW_STR/CW_BLOB cipher: 0=per-site feistel, 1=aes-128-ctr (aes-ni when present)
+#endif
+
 #if CW_ENABLE_DATA_HIDING && !CW_ENABLE_COMPILE_TIME_RANDOM
     #error "CW_ENABLE_DATA_HIDING requires CW_ENABLE_COMPILE_TIME_RANDOM to be enabled"
 #endif
@@ -461,9 +516,23 @@ Refer to the README.md for usage.
     #include <vector>
     #include <algorithm>
     #include <atomic>
+    #include <iterator>
     #include <mutex>
     #include <memory>
     #include <bit>
+    #include <thread>
+    #include <string_view>
+    #include <chrono>
+    #include <type_traits>
+    #if __has_include(<format>)
+        #include <format>
+    #endif
+
+    #ifdef CW_LOG_DECODER
+        #include <cstdio>
+        #include <string>
+        #include <unordered_map>
+    #endif
 
     #ifdef _WIN32
         #include <windows.h>
@@ -504,7 +573,13 @@ Refer to the README.md for usage.
         }
     #else
         #include <cstdint>
-        #include <cpuid.h>
+        #include <cstring>
+        #include <ctime>
+        #include <chrono>
+        #if defined(__x86_64__) || defined(__i386__)
+            #include <cpuid.h>
+            #include <x86intrin.h>
+        #endif
     #endif
 
     #define CW_ATOMIC(T) std::atomic<T>
@@ -527,6 +602,11 @@ Refer to the README.md for usage.
     #pragma warning(push)
     #pragma warning(disable: 4996 4244 4267)
     #define CW_RDSEED
+    #define CW_TARGET(x)
+    #define CW_NO_ASAN __declspec(no_sanitize_address)
+    #define CW_SEH_TRY __try
+    #define CW_SEH_EXCEPT __except (EXCEPTION_EXECUTE_HANDLER)
+    #define CW_LAUNDER(p) ((p) = *static_cast<decltype(p) volatile*>(&(p)))
 #elif defined(__GNUC__) || defined(__clang__)
 
     #define CW_FORCEINLINE __attribute__((always_inline)) inline
@@ -536,6 +616,13 @@ Refer to the README.md for usage.
     #define CW_OPT_OFF _Pragma("GCC push_options") _Pragma("GCC optimize(\"O0\")")
     #define CW_OPT_ON _Pragma("GCC pop_options")
     #define CW_RDSEED __attribute__((target("rdseed")))
+    #define CW_TARGET(x) __attribute__((target(x)))
+    #define CW_NO_ASAN __attribute__((no_sanitize_address))
+    // no SEH here - the guarded block just runs and the handler is dead code
+    #define CW_SEH_TRY if (true)
+    #define CW_SEH_EXCEPT else
+    // hides where a pointer points so loads through it can't be constant-folded
+    #define CW_LAUNDER(p) asm volatile("" : "+r"(p))
 #else
     #define CW_FORCEINLINE inline
     #define CW_NOINLINE
@@ -544,6 +631,17 @@ Refer to the README.md for usage.
     #define CW_OPT_OFF
     #define CW_OPT_ON
     #define CW_RDSEED
+    #define CW_TARGET(x)
+    #define CW_NO_ASAN
+    #define CW_SEH_TRY if (true)
+    #define CW_SEH_EXCEPT else
+    #define CW_LAUNDER(p) ((p) = *static_cast<decltype(p) volatile*>(&(p)))
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define CW_ARCH_X86 1
+#else
+    #define CW_ARCH_X86 0
 #endif
 
 // =================================================================
@@ -555,12 +653,41 @@ Refer to the README.md for usage.
 // CW_STR("text")                   - encrypts string at compile-time, decrypts at runtime
 //                                    usage: const char* msg = CW_STR("secret message");
 //
-// CW_STR_LAYERED("text")           - multi-layer encrypted string with polymorphic re-encryption
+// CW_STR_SHARED("text")            - CW_STR keyed by content: identical literals program-wide share
+//                                    one ciphertext and one decrypted instance
+//
+// CW_STR_LAYERED("text")           - multi-layer encrypted string with polymorphic re-encryption;
+//                                    the pointer is valid until this thread reads the string again
 //                                    usage: const char* msg = CW_STR_LAYERED("secret");
 //
+// CW_SV("text") / CW_WSV(L"text")  - CW_STR / CW_WSTR as std::string_view / std::wstring_view, no strlen
+//                                    usage: std::string_view v = CW_SV("secret");
+//
+// CW_STR_LAYERED_N("text", n)      - layered string re-keyed every n accesses per thread
+//                                    usage: const char* msg = CW_STR_LAYERED_N("secret", 1000);
+//
 // CW_STR_STACK("text")              - stack-based encrypted string (auto-cleanup)
 //                                    usage: auto msg = CW_STR_STACK("secret");
 //
+// CW_WITH_DECRYPTED("text", fn)    - fn(std::string_view) on a stack copy, wiped on return
+//                                    usage: CW_WITH_DECRYPTED("key", [&](std::string_view v) { use(v); });
+//
+// CW_STR_EQ(input, "text")         - compares input with an encrypted literal block by block, early exit
+//                                    usage: if (CW_STR_EQ(cmd, "shutdown")) stop();
+// CW_STR_EQ_CT(input, "text")      - same, constant time for inputs of the literal's length
+// CW_STR_STARTS_WITH(input, "text") - input begins with the literal
+//
+// CW_FMT_TO(out, "fmt {}", args...) - std::format_to with a stack-decrypted, wiped format string
+//                                    usage: char buf[64]; *CW_FMT_TO(buf, "user {} failed", id) = 0;
+// CW_FMT_TO_N(out, n, "fmt", ...)   - bounded variant, returns std::format_to_n_result
+//                                    both need <format> (gcc 13+, clang 17+, msvc 19.29+)
+//
+// string_encrypt::predecrypt_all() - decrypts every CW_STR/CW_WSTR site in parallel (warmup)
+//                                    usage: cloakwork::string_encrypt::predecrypt_all(4);
+//
+// cloakwork::wipe_all()            - with CW_TRIVIAL_STRINGS=1: re-encrypts every decrypted string site
+//                                    usage: size_t wiped = cloakwork::wipe_all();
+//
 // INTEGER/VALUE OBFUSCATION
 // -------------------------
 // CW_INT(value)                    - obfuscates integer/numeric values
@@ -708,6 +835,22 @@ Refer to the README.md for usage.
 // ----------------------
 // CW_WSTR(L"text")                  - encrypts wide string at compile-time
 //                                    usage: const wchar_t* msg = CW_WSTR(L"secret");
+// CW_U8STR / CW_U16STR / CW_U32STR  - same for u8"" / u"" / U"" literals (native code-unit cipher)
+//                                    usage: const char16_t* msg = CW_U16STR(u"secret");
+//
+// ENCRYPTED BLOBS
+// ---------------
+// CW_BLOB(array)                    - chunked compile-time encryption of a static constexpr byte array
+//                                    usage: auto b = CW_BLOB(cert_der); b.read(0, out, b.size());
+// blob.decrypt_chunk(i, buf)        - decrypts one CW_BLOB_CHUNK_SIZE chunk into buf, returns its length
+// blob.for_each_chunk(buf, fn)      - streams all chunks through buf into fn(ptr, len), wipes buf after
+//
+// DEFERRED LOGGING
+// ----------------
+// CW_LOG(level, "fmt {}", args...)  - binary log record into a per-thread ring; fmt stays encrypted in-process
+//                                    usage: CW_LOG(warn, "retry {} of {}", n, max);
+// logging::drain(sink)              - writes rings + new manifest entries to sink(ptr, len), single consumer
+// logging::decode(data, len, key)   - (CW_LOG_DECODER) offline decode to text, see tools/cw_logdecode.cpp
 //
 // STRING HASHING
 // --------------
@@ -723,11 +866,17 @@ Refer to the README.md for usage.
 // hash::fnv1a_runtime(str)          - runtime hash of string
 //                                    usage: uint32_t h = hash::fnv1a_runtime(dynamicStr);
 //
+// hash::fnv1a_runtime(str, len)     - runtime hash of a counted (unterminated) buffer
+//                                    usage: uint32_t h = hash::fnv1a_runtime_ci_w2a(entry->BaseDllName);
+//
 // IMPORT HIDING
 // -------------
 // CW_IMPORT(mod, func)              - resolve function without import table
 //                                    usage: auto pFunc = CW_IMPORT("kernel32.dll", VirtualAlloc);
 //
+// CW_IMPORT_SET(mod, funcs...)      - resolve many functions in one export pass and cache them
+//                                    usage: CW_IMPORT_SET("kernel32.dll", VirtualAlloc, VirtualFree);
+//
 // imports::getModuleBase(hash)      - get module base by hash
 //                                    usage: void* ntdll = imports::getModuleBase(CW_HASH("ntdll.dll"));
 //
@@ -836,6 +985,368 @@ Refer to the README.md for usage.
 
 namespace cloakwork {
 
+    // portable intrinsics. msvc exposes these directly, gcc/clang need builtins or
+    // target attributes, so everything that touches popcnt/bsf/crc32/rdtsc goes
+    // through here. cpuid runs once; popcnt and crc32 fall back to software when
+    // the cpu doesn't have them instead of faulting on an illegal instruction.
+    namespace intrin {
+        struct cpu_features {
+            bool popcnt;
+            bool sse42;
+            bool avx2;
+            bool aes;
+            bool rdseed;
+            bool hypervisor;
+        };
+
+        CW_FORCEINLINE void cpuid(int out[4], int leaf, int subleaf = 0) {
+#if defined(_MSC_VER) && CW_ARCH_X86
+            __cpuidex(out, leaf, subleaf);
+#elif CW_ARCH_X86
+            unsigned int a = 0, b = 0, c = 0, d = 0;
+            __cpuid_count(leaf, subleaf, a, b, c, d);
+            out[0] = static_cast<int>(a);
+            out[1] = static_cast<int>(b);
+            out[2] = static_cast<int>(c);
+            out[3] = static_cast<int>(d);
+#else
+            (void)leaf; (void)subleaf;
+            out[0] = out[1] = out[2] = out[3] = 0;
+#endif
+        }
+
+        inline cpu_features detect_cpu() {
+            cpu_features f{};
+#if CW_ARCH_X86
+            int info[4];
+            cpuid(info, 0);
+            const int max_leaf = info[0];
+
+            if (max_leaf >= 1) {
+                cpuid(info, 1);
+                f.sse42      = (info[2] & (1 << 20)) != 0;
+                f.popcnt     = (info[2] & (1 << 23)) != 0;
+                f.aes        = (info[2] & (1 << 25)) != 0;
+                f.hypervisor = (info[2] & (1u << 31)) != 0;
+
+                // avx2 also needs the os to save ymm state (osxsave + xcr0 bits 1,2)
+                bool os_avx = false;
+                if ((info[2] & (1 << 27)) && (info[2] & (1 << 28))) {
+#if defined(_MSC_VER)
+                    os_avx = (_xgetbv(0) & 0x6) == 0x6;
+#else
+                    unsigned int xlo, xhi;
+                    __asm__ volatile("xgetbv" : "=a"(xlo), "=d"(xhi) : "c"(0));
+                    os_avx = (xlo & 0x6) == 0x6;
+#endif
+                }
+
+                if (max_leaf >= 7) {
+                    cpuid(info, 7, 0);
+                    f.avx2   = os_avx && (info[1] & (1 << 5)) != 0;
+                    f.rdseed = (info[1] & (1 << 18)) != 0;
+                }
+            }
+#endif
+            return f;
+        }
+
+        inline const cpu_features& cpu() {
+            static const cpu_features features = detect_cpu();
+            return features;
+        }
+
+        CW_FORCEINLINE uint64_t rdtsc() {
+#if CW_ARCH_X86
+            return __rdtsc();
+#elif CW_KERNEL_MODE
+            return static_cast<uint64_t>(KeQueryPerformanceCounter(nullptr).QuadPart);
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+            uint64_t v;
+            __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+            return v;
+#else
+            return static_cast<uint64_t>(
+                std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        constexpr uint32_t popcnt32_soft(uint32_t v) {
+            v = v - ((v >> 1) & 0x55555555u);
+            v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+            v = (v + (v >> 4)) & 0x0F0F0F0Fu;
+            return (v * 0x01010101u) >> 24;
+        }
+
+#if CW_ARCH_X86
+        CW_TARGET("popcnt") inline uint32_t popcnt32_hw(uint32_t v) {
+#if defined(_MSC_VER)
+            return __popcnt(v);
+#else
+            return static_cast<uint32_t>(__builtin_popcount(v));
+#endif
+        }
+#endif
+
+        CW_FORCEINLINE uint32_t popcnt32(uint32_t v) {
+#if CW_ARCH_X86
+            if (cpu().popcnt) return popcnt32_hw(v);
+#endif
+            return popcnt32_soft(v);
+        }
+
+        // index of lowest / highest set bit. v must be nonzero (same contract as bsf/bsr)
+        CW_FORCEINLINE uint32_t bsf32(uint32_t v) {
+#if defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanForward(&idx, v);
+            return static_cast<uint32_t>(idx);
+#else
+            return static_cast<uint32_t>(__builtin_ctz(v));
+#endif
+        }
+
+        CW_FORCEINLINE uint32_t bsr32(uint32_t v) {
+#if defined(_MSC_VER)
+            unsigned long idx;
+            _BitScanReverse(&idx, v);
+            return static_cast<uint32_t>(idx);
+#else
+            return 31u - static_cast<uint32_t>(__builtin_clz(v));
+#endif
+        }
+
+        // crc32c (castagnoli), bit-for-bit what the sse4.2 crc32 instruction computes
+        constexpr uint32_t crc32c_u32_soft(uint32_t crc, uint32_t v) {
+            crc ^= v;
+            for (int i = 0; i < 32; ++i)
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+            return crc;
+        }
+
+#if CW_ARCH_X86
+        CW_TARGET("sse4.2") inline uint32_t crc32c_u32_hw(uint32_t crc, uint32_t v) {
+            return _mm_crc32_u32(crc, v);
+        }
+#endif
+
+        CW_FORCEINLINE uint32_t crc32c_u32(uint32_t crc, uint32_t v) {
+#if CW_ARCH_X86
+            if (cpu().sse42) return crc32c_u32_hw(crc, v);
+#endif
+            return crc32c_u32_soft(crc, v);
+        }
+
+#if defined(_M_X64) || defined(__x86_64__)
+        CW_RDSEED inline bool rdseed64_hw(uint64_t& out) {
+            unsigned long long v = 0;
+            if (!_rdseed64_step(&v)) return false;
+            out = static_cast<uint64_t>(v);
+            return true;
+        }
+#endif
+
+        CW_FORCEINLINE bool rdseed64(uint64_t& out) {
+#if defined(_M_X64) || defined(__x86_64__)
+            return cpu().rdseed && rdseed64_hw(out);
+#else
+            (void)out;
+            return false;
+#endif
+        }
+
+        // spin-wait hint (pause / yield)
+        CW_FORCEINLINE void cpu_pause() {
+#if CW_ARCH_X86
+            _mm_pause();
+#elif defined(_MSC_VER)
+            __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+            __asm__ volatile("yield");
+#else
+            CW_COMPILER_BARRIER();
+#endif
+        }
+
+        CW_FORCEINLINE void debug_break() {
+#if defined(_MSC_VER)
+            __debugbreak();
+#elif CW_ARCH_X86
+            __asm__ volatile("int3");
+#else
+            __builtin_trap();
+#endif
+        }
+    }
+
+    // u32 lanes for running independent cipher blocks side by side.
+    // gcc/clang use vector extensions: the operators are target-neutral, so code
+    // force-inlined into a CW_TARGET("avx2") function comes out as ymm ops and
+    // everything else as plain sse2. msvc gets thin wrappers over the intrinsics.
+    // either way a lane type supports the same + - * ^ | & << >> as uint32_t,
+    // scalars broadcast, so round functions can be written once over a typename V.
+#if CW_ARCH_X86 && !CW_KERNEL_MODE
+    #define CW_SIMD 1
+#else
+    #define CW_SIMD 0
+#endif
+
+#if CW_SIMD
+    namespace simd {
+#if defined(__GNUC__) || defined(__clang__)
+        typedef uint32_t u32x4 __attribute__((vector_size(16)));
+        typedef uint32_t u32x8 __attribute__((vector_size(32)));
+
+        // split lanes*8 bytes of consecutive 64-bit blocks into low/high words
+        template<typename V>
+        CW_FORCEINLINE void load_blocks(const uint8_t* p, V& v0, V& v1) {
+            for (size_t j = 0; j < sizeof(V) / 4; ++j) {
+                uint32_t lo, hi;
+                memcpy(&lo, p + j * 8, 4);
+                memcpy(&hi, p + j * 8 + 4, 4);
+                v0[j] = lo;
+                v1[j] = hi;
+            }
+        }
+
+        template<typename V>
+        CW_FORCEINLINE void store_blocks(uint8_t* p, const V& v0, const V& v1) {
+            for (size_t j = 0; j < sizeof(V) / 4; ++j) {
+                uint32_t lo = v0[j], hi = v1[j];
+                memcpy(p + j * 8, &lo, 4);
+                memcpy(p + j * 8 + 4, &hi, 4);
+            }
+        }
+
+        CW_FORCEINLINE __m128i raw(u32x4 v) { return reinterpret_cast<__m128i>(v); }
+        CW_FORCEINLINE u32x4 lane_index() { return u32x4{ 0, 1, 2, 3 }; }
+        CW_TARGET("avx2") CW_FORCEINLINE __m256i raw(u32x8 v) { return reinterpret_cast<__m256i>(v); }
+        CW_TARGET("avx2") CW_FORCEINLINE u32x8 lane_index8() { return u32x8{ 0, 1, 2, 3, 4, 5, 6, 7 }; }
+#else
+        struct u32x4 {
+            __m128i v;
+            CW_FORCEINLINE u32x4() = default;
+            CW_FORCEINLINE u32x4(__m128i x) : v(x) {}
+            CW_FORCEINLINE u32x4(uint32_t x) : v(_mm_set1_epi32(static_cast<int>(x))) {}
+        };
+
+        CW_FORCEINLINE u32x4 operator+(u32x4 a, u32x4 b) { return _mm_add_epi32(a.v, b.v); }
+        CW_FORCEINLINE u32x4 operator-(u32x4 a, u32x4 b) { return _mm_sub_epi32(a.v, b.v); }
+        CW_FORCEINLINE u32x4 operator^(u32x4 a, u32x4 b) { return _mm_xor_si128(a.v, b.v); }
+        CW_FORCEINLINE u32x4 operator|(u32x4 a, u32x4 b) { return _mm_or_si128(a.v, b.v); }
+        CW_FORCEINLINE u32x4 operator&(u32x4 a, u32x4 b) { return _mm_and_si128(a.v, b.v); }
+        CW_FORCEINLINE u32x4 operator<<(u32x4 a, uint32_t n) { return _mm_slli_epi32(a.v, static_cast<int>(n)); }
+        CW_FORCEINLINE u32x4 operator>>(u32x4 a, uint32_t n) { return _mm_srli_epi32(a.v, static_cast<int>(n)); }
+        CW_FORCEINLINE u32x4 operator*(u32x4 a, u32x4 b) {
+            // sse2 has no pmulld: multiply even and odd lanes separately
+            __m128i even = _mm_mul_epu32(a.v, b.v);
+            __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                      _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+        CW_FORCEINLINE u32x4& operator+=(u32x4& a, u32x4 b) { return a = a + b; }
+        CW_FORCEINLINE u32x4& operator-=(u32x4& a, u32x4 b) { return a = a - b; }
+        CW_FORCEINLINE u32x4& operator^=(u32x4& a, u32x4 b) { return a = a ^ b; }
+
+        CW_FORCEINLINE __m128i raw(u32x4 v) { return v.v; }
+        CW_FORCEINLINE u32x4 lane_index() { return _mm_setr_epi32(0, 1, 2, 3); }
+
+        struct u32x8 {
+            __m256i v;
+            CW_FORCEINLINE u32x8() = default;
+            CW_FORCEINLINE u32x8(__m256i x) : v(x) {}
+            CW_FORCEINLINE u32x8(uint32_t x) : v(_mm256_set1_epi32(static_cast<int>(x))) {}
+        };
+
+        CW_FORCEINLINE u32x8 operator+(u32x8 a, u32x8 b) { return _mm256_add_epi32(a.v, b.v); }
+        CW_FORCEINLINE u32x8 operator-(u32x8 a, u32x8 b) { return _mm256_sub_epi32(a.v, b.v); }
+        CW_FORCEINLINE u32x8 operator^(u32x8 a, u32x8 b) { return _mm256_xor_si256(a.v, b.v); }
+        CW_FORCEINLINE u32x8 operator|(u32x8 a, u32x8 b) { return _mm256_or_si256(a.v, b.v); }
+        CW_FORCEINLINE u32x8 operator&(u32x8 a, u32x8 b) { return _mm256_and_si256(a.v, b.v); }
+        CW_FORCEINLINE u32x8 operator<<(u32x8 a, uint32_t n) { return _mm256_slli_epi32(a.v, static_cast<int>(n)); }
+        CW_FORCEINLINE u32x8 operator>>(u32x8 a, uint32_t n) { return _mm256_srli_epi32(a.v, static_cast<int>(n)); }
+        CW_FORCEINLINE u32x8 operator*(u32x8 a, u32x8 b) { return _mm256_mullo_epi32(a.v, b.v); }
+        CW_FORCEINLINE u32x8& operator+=(u32x8& a, u32x8 b) { return a = a + b; }
+        CW_FORCEINLINE u32x8& operator-=(u32x8& a, u32x8 b) { return a = a - b; }
+        CW_FORCEINLINE u32x8& operator^=(u32x8& a, u32x8 b) { return a = a ^ b; }
+
+        CW_FORCEINLINE __m256i raw(u32x8 v) { return v.v; }
+        CW_FORCEINLINE u32x8 lane_index8() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+
+        // blocks are [lo hi][lo hi]...; shuffle_ps picks evens/odds across two regs
+        CW_FORCEINLINE void load_blocks(const uint8_t* p, u32x4& v0, u32x4& v1) {
+            __m128 a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            __m128 b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+            v0 = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            v1 = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+
+        CW_FORCEINLINE void store_blocks(uint8_t* p, const u32x4& v0, const u32x4& v1) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p),      _mm_unpacklo_epi32(v0.v, v1.v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16), _mm_unpackhi_epi32(v0.v, v1.v));
+        }
+
+        // 256-bit shuffles stay inside 128-bit halves, so fix lane order with a permute
+        CW_FORCEINLINE void load_blocks(const uint8_t* p, u32x8& v0, u32x8& v1) {
+            __m256 a = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+            __m256 b = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)));
+            __m256i lo = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            __m256i hi = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            v0 = _mm256_permute4x64_epi64(lo, _MM_SHUFFLE(3, 1, 2, 0));
+            v1 = _mm256_permute4x64_epi64(hi, _MM_SHUFFLE(3, 1, 2, 0));
+        }
+
+        CW_FORCEINLINE void store_blocks(uint8_t* p, const u32x8& v0, const u32x8& v1) {
+            __m256i lo = _mm256_unpacklo_epi32(v0.v, v1.v);   // blocks 0 1 | 4 5
+            __m256i hi = _mm256_unpackhi_epi32(v0.v, v1.v);   // blocks 2 3 | 6 7
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),      _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+#endif
+
+        // position-keyed keystreams make one 32-bit word per byte position; these
+        // keep the low byte of each lane, in lane order. sse2 has only signed
+        // 32->16 packing, so mask first to keep the values in range
+        CW_FORCEINLINE __m128i low_bytes(u32x4 a, u32x4 b, u32x4 c, u32x4 d) {
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            __m128i ab = _mm_packs_epi32(_mm_and_si128(raw(a), mask), _mm_and_si128(raw(b), mask));
+            __m128i cd = _mm_packs_epi32(_mm_and_si128(raw(c), mask), _mm_and_si128(raw(d), mask));
+            return _mm_packus_epi16(ab, cd);
+        }
+
+        CW_FORCEINLINE uint32_t low_bytes(u32x4 a) {
+            __m128i w = _mm_packs_epi32(_mm_and_si128(raw(a), _mm_set1_epi32(0xFF)), _mm_setzero_si128());
+            return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(w, w)));
+        }
+
+        // the packs work per 128-bit half, leaving 4-byte groups a0 b0 c0 d0 a1 b1 c1 d1
+        CW_TARGET("avx2") CW_FORCEINLINE __m256i low_bytes(u32x8 a, u32x8 b, u32x8 c, u32x8 d) {
+            const __m256i mask = _mm256_set1_epi32(0xFF);
+            __m256i ab = _mm256_packs_epi32(_mm256_and_si256(raw(a), mask), _mm256_and_si256(raw(b), mask));
+            __m256i cd = _mm256_packs_epi32(_mm256_and_si256(raw(c), mask), _mm256_and_si256(raw(d), mask));
+            return _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        }
+
+        // xors 32 / 16 / 4 keystream bytes into p
+        CW_TARGET("avx2") CW_FORCEINLINE void xor_bytes(uint8_t* p, __m256i ks) {
+            __m256i* q = reinterpret_cast<__m256i*>(p);
+            _mm256_storeu_si256(q, _mm256_xor_si256(_mm256_loadu_si256(q), ks));
+        }
+
+        CW_FORCEINLINE void xor_bytes(uint8_t* p, __m128i ks) {
+            __m128i* q = reinterpret_cast<__m128i*>(p);
+            _mm_storeu_si128(q, _mm_xor_si128(_mm_loadu_si128(q), ks));
+        }
+
+        CW_FORCEINLINE void xor_bytes(uint8_t* p, uint32_t ks) {
+            uint32_t w;
+            memcpy(&w, p, 4);
+            w ^= ks;
+            memcpy(p, &w, 4);
+        }
+    }
+#endif
+
 #if CW_ENABLE_COMPILE_TIME_RANDOM
     namespace detail {
         template<size_t N>
@@ -849,18 +1360,7 @@ namespace cloakwork {
         }
 
         inline bool try_hardware_random(uint64_t& out) {
-            static bool has_rdseed = [] {
-#if defined(_MSC_VER)
-                int cpuInfo[4];
-                __cpuidex(cpuInfo, 7, 0);
-                return (cpuInfo[1] & (1 << 18)) != 0;
-#elif defined(__GNUC__) || defined(__clang__)
-                unsigned int eax, ebx, ecx, edx;
-                return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1 << 18)) != 0;
-#endif
-            }();
-
-            return has_rdseed && _rdseed64_step(reinterpret_cast<unsigned long long*>(&out));
+            return intrin::rdseed64(out);
         }
 
         // not cryptographic - just makes runtime keys unique per execution
@@ -927,6 +1427,7 @@ namespace cloakwork {
                 HeapFree(GetProcessHeap(), 0, heap_alloc);
             }
 #else
+            entropy ^= intrin::rdtsc();
             entropy ^= reinterpret_cast<uint64_t>(&entropy);
             entropy ^= static_cast<uint64_t>(time(nullptr));
 #endif
@@ -1122,6 +1623,105 @@ namespace cloakwork {
             return hash;
         }
 
+        //
+        // counted overloads. these never read str[len], so they work on buffers
+        // with no terminator (UNICODE_STRING, string_view, PE name tables), and
+        // with the trip count known up front the loop unrolls instead of testing
+        // every byte for NUL. results match the NUL-terminated versions.
+        //
+        namespace fnv_detail {
+            template<bool CI, bool Wide, typename CharT>
+            CW_FORCEINLINE uint32_t step(uint32_t hash, CharT c) {
+                if (CI && c >= 'A' && c <= 'Z') c += 32;
+                hash ^= static_cast<uint8_t>(c & 0xFF);
+                hash *= 0x01000193;
+                if constexpr (Wide) {
+                    hash ^= static_cast<uint8_t>((c >> 8) & 0xFF);
+                    hash *= 0x01000193;
+                }
+                return hash;
+            }
+
+            template<bool CI, bool Wide, typename CharT>
+            CW_FORCEINLINE uint32_t counted(const CharT* str, size_t len) {
+                uint32_t hash = 0x811c9dc5;
+                size_t i = 0;
+                for (; i + 4 <= len; i += 4) {
+                    hash = step<CI, Wide>(hash, str[i]);
+                    hash = step<CI, Wide>(hash, str[i + 1]);
+                    hash = step<CI, Wide>(hash, str[i + 2]);
+                    hash = step<CI, Wide>(hash, str[i + 3]);
+                }
+                for (; i < len; ++i)
+                    hash = step<CI, Wide>(hash, str[i]);
+                return hash;
+            }
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime(const char* str, size_t len) {
+            return fnv_detail::counted<false, false>(str, len);
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime(const wchar_t* str, size_t len) {
+            return fnv_detail::counted<false, true>(str, len);
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci(const char* str, size_t len) {
+            return fnv_detail::counted<true, false>(str, len);
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci(const wchar_t* str, size_t len) {
+            return fnv_detail::counted<true, true>(str, len);
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci_w2a(const wchar_t* str, size_t len) {
+            return fnv_detail::counted<true, false>(str, len);
+        }
+
+        // hashes up to the first NUL or max bytes, whichever comes first. for
+        // names inside a mapped image, where max is the distance to the image end
+        CW_FORCEINLINE uint32_t fnv1a_runtime_bounded(const char* str, size_t max) {
+            uint32_t hash = 0x811c9dc5;
+            for (size_t i = 0; i < max && str[i]; ++i) {
+                hash ^= static_cast<uint8_t>(str[i]);
+                hash *= 0x01000193;
+            }
+            return hash;
+        }
+
+#if !CW_KERNEL_MODE
+        CW_FORCEINLINE uint32_t fnv1a_runtime(std::string_view str) {
+            return fnv1a_runtime(str.data(), str.size());
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime(std::wstring_view str) {
+            return fnv1a_runtime(str.data(), str.size());
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci(std::string_view str) {
+            return fnv1a_runtime_ci(str.data(), str.size());
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci(std::wstring_view str) {
+            return fnv1a_runtime_ci(str.data(), str.size());
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci_w2a(std::wstring_view str) {
+            return fnv1a_runtime_ci_w2a(str.data(), str.size());
+        }
+#endif
+
+#if defined(_WIN32) || CW_KERNEL_MODE
+        // Length is in bytes and Buffer need not be terminated
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci_w2a(const UNICODE_STRING& str) {
+            return fnv1a_runtime_ci_w2a(str.Buffer, str.Length / sizeof(WCHAR));
+        }
+
+        CW_FORCEINLINE uint32_t fnv1a_runtime_ci(const UNICODE_STRING& str) {
+            return fnv1a_runtime_ci(str.Buffer, str.Length / sizeof(WCHAR));
+        }
+#endif
+
         consteval uint32_t fnv1a_ci(const char* str, size_t len) {
             uint32_t hash = 0x811c9dc5;
             for (size_t i = 0; i < len; ++i) {
@@ -1143,65 +1743,923 @@ namespace cloakwork {
     #define CW_HASH_WIDE(s) ([]() consteval { return cloakwork::hash::fnv1a_wide(s); }())
     #define CW_HASH_CI(s) ([]() consteval { return cloakwork::hash::fnv1a_ci(s); }())
 
-    namespace internal_cipher {
+    //
+    // 64-bit word-at-a-time hash in the style of wyhash. inputs are consumed 16
+    // bytes per 128-bit multiply instead of one byte per dependent multiply, and
+    // the 64-bit output keeps collisions negligible for very large name sets.
+    // one constexpr core serves both the consteval and the runtime entry points,
+    // so CW_HASH64("x") == hash64_runtime("x") by construction. the _ci variants
+    // lowercase 'A'-'Z' only, eight bytes at a time, exactly like fnv1a_ci.
+    //
+    namespace hash {
+        namespace hash64_detail {
+            inline constexpr uint64_t s0 = 0xA0761D6478BD642Full;
+            inline constexpr uint64_t s1 = 0xE7037ED1A0B428DBull;
+            inline constexpr uint64_t s2 = 0x8EBC6AF09C88C6E3ull;
+
+            // full 64x64 -> 128 product, returned as lo ^ hi
+            CW_FORCEINLINE constexpr uint64_t mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+                unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+                return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+                if (!__builtin_is_constant_evaluated()) {
+                    uint64_t hi;
+                    uint64_t lo = _umul128(a, b, &hi);
+                    return lo ^ hi;
+                }
+#endif
+                uint64_t al = a & 0xFFFFFFFFu, ah = a >> 32;
+                uint64_t bl = b & 0xFFFFFFFFu, bh = b >> 32;
+                uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+                uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+                uint64_t lo = (mid << 32) | (ll & 0xFFFFFFFFu);
+                uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+                return lo ^ hi;
+#endif
+            }
 
-        //
-        // position-dependent xor cipher to prevent Hex-Rays stack-string reconstruction.
-        // mix constants are derived from the Key so each stub has unique imul operands
-        // and shift widths — prevents pattern scanning for fixed magic values.
-        //
-        template<uint32_t Key>
-        struct cipher_params {
-            static constexpr uint32_t mix_a = 0x9E3779B9u ^ (Key * 0x01000193u);
-            static constexpr uint32_t mix_b = 0x45D9F3Bu ^ ((Key >> 7) * 0x27D4EB2Du);
-            static constexpr uint32_t shift_a = 13u + (Key & 3u);
-            static constexpr uint32_t shift_b = 11u + ((Key >> 2) & 3u);
-            static constexpr bool extra_round = (Key & 0x10u) != 0;
-        };
+            // sets bit 5 of every byte in 'A'..'Z'; bytes >= 0x80 are left alone
+            CW_FORCEINLINE constexpr uint64_t lower8(uint64_t w) {
+                constexpr uint64_t ones = 0x0101010101010101ull;
+                uint64_t low7 = w & (0x7F * ones);
+                uint64_t ge_a = low7 + (0x80 - 'A') * ones;
+                uint64_t gt_z = low7 + (0x7F - 'Z') * ones;
+                return w | (((ge_a ^ gt_z) & ~w & (0x80 * ones)) >> 2);
+            }
 
-        template<uint32_t Key, size_t N>
-        struct encrypted_buf {
-            uint8_t data[N];
+            template<typename CharT>
+            CW_FORCEINLINE constexpr uint64_t byte(const CharT* p, size_t i) {
+                return static_cast<uint8_t>(p[i] & 0xFF);
+            }
 
-            consteval encrypted_buf(const char (&str)[N]) : data{} {
-                using P = cipher_params<Key>;
-                for (size_t i = 0; i < N; ++i) {
-                    uint32_t subkey = Key ^ (static_cast<uint32_t>(i) * P::mix_a);
-                    subkey ^= subkey >> P::shift_a;
-                    subkey *= P::mix_b;
-                    subkey ^= subkey >> P::shift_b;
-                    if constexpr (P::extra_round) {
-                        subkey ^= subkey >> 7;
-                        subkey *= 0x119DE1F3u ^ (Key >> 16);
-                    }
-                    data[i] = static_cast<uint8_t>(str[i]) ^ static_cast<uint8_t>(subkey);
+            // little-endian loads of the low byte of each code unit. runtime
+            // char input takes a single unaligned load (x86/arm64 are little-endian)
+            template<bool CI, typename CharT>
+            CW_FORCEINLINE constexpr uint64_t load8(const CharT* p) {
+                uint64_t v;
+                if (sizeof(CharT) == 1 && !__builtin_is_constant_evaluated()) {
+                    memcpy(&v, p, 8);
+                } else {
+                    v = byte(p, 0) | byte(p, 1) << 8 | byte(p, 2) << 16 | byte(p, 3) << 24 |
+                        byte(p, 4) << 32 | byte(p, 5) << 40 | byte(p, 6) << 48 | byte(p, 7) << 56;
                 }
+                return CI ? lower8(v) : v;
             }
-        };
 
-        template<uint32_t Key, size_t N>
-        CW_NOINLINE void decrypt_to_stack(const encrypted_buf<Key, N>& enc, char (&out)[N]) {
-            using P = cipher_params<Key>;
-            volatile uint8_t* dst = reinterpret_cast<volatile uint8_t*>(out);
-            for (size_t i = 0; i < N; ++i) {
-                uint32_t subkey = Key ^ (static_cast<uint32_t>(i) * P::mix_a);
-                subkey ^= subkey >> P::shift_a;
-                subkey *= P::mix_b;
-                subkey ^= subkey >> P::shift_b;
-                if constexpr (P::extra_round) {
-                    subkey ^= subkey >> 7;
-                    subkey *= 0x119DE1F3u ^ (Key >> 16);
+            template<bool CI, typename CharT>
+            CW_FORCEINLINE constexpr uint64_t load4(const CharT* p) {
+                uint64_t v;
+                if (sizeof(CharT) == 1 && !__builtin_is_constant_evaluated()) {
+                    uint32_t w;
+                    memcpy(&w, p, 4);
+                    v = w;
+                } else {
+                    v = byte(p, 0) | byte(p, 1) << 8 | byte(p, 2) << 16 | byte(p, 3) << 24;
                 }
-                dst[i] = enc.data[i] ^ static_cast<uint8_t>(subkey);
+                return CI ? lower8(v) : v;
+            }
+
+            // 1..3 bytes: first, middle and last byte
+            template<bool CI, typename CharT>
+            CW_FORCEINLINE constexpr uint64_t load3(const CharT* p, size_t len) {
+                uint64_t v = byte(p, 0) << 16 | byte(p, len >> 1) << 8 | byte(p, len - 1);
+                return CI ? lower8(v) : v;
+            }
+
+            template<bool CI, typename CharT>
+            constexpr uint64_t hash(const CharT* p, size_t len, uint64_t seed) {
+                seed ^= mix(seed ^ s0, s1);
+                uint64_t a, b;
+                if (len <= 16) {
+                    if (len >= 4) {
+                        size_t off = (len >> 3) << 2;
+                        a = (load4<CI>(p) << 32) | load4<CI>(p + off);
+                        b = (load4<CI>(p + len - 4) << 32) | load4<CI>(p + len - 4 - off);
+                    } else if (len > 0) {
+                        a = load3<CI>(p, len);
+                        b = 0;
+                    } else {
+                        a = b = 0;
+                    }
+                } else {
+                    size_t i = len;
+                    if (i > 48) {
+                        // three independent lanes keep the multiplier busy on long input
+                        uint64_t see1 = seed, see2 = seed;
+                        do {
+                            seed = mix(load8<CI>(p) ^ s1, load8<CI>(p + 8) ^ seed);
+                            see1 = mix(load8<CI>(p + 16) ^ s2, load8<CI>(p + 24) ^ see1);
+                            see2 = mix(load8<CI>(p + 32) ^ s0, load8<CI>(p + 40) ^ see2);
+                            p += 48;
+                            i -= 48;
+                        } while (i > 48);
+                        seed ^= see1 ^ see2;
+                    }
+                    while (i > 16) {
+                        seed = mix(load8<CI>(p) ^ s1, load8<CI>(p + 8) ^ seed);
+                        p += 16;
+                        i -= 16;
+                    }
+                    a = load8<CI>(p + i - 16);
+                    b = load8<CI>(p + i - 8);
+                }
+                return mix(s1 ^ len, mix(a ^ s1, b ^ seed) ^ s0);
+            }
+
+            // strlen eight bytes at a time. the aligned word reads can run past
+            // the terminator but never into the next page, hence CW_NO_ASAN
+            CW_NO_ASAN inline size_t length(const char* str) {
+                constexpr uint64_t ones = 0x0101010101010101ull;
+                const char* p = str;
+                for (; reinterpret_cast<uintptr_t>(p) & 7; ++p)
+                    if (!*p) return static_cast<size_t>(p - str);
+                for (;; p += 8) {
+                    uint64_t w;
+                    memcpy(&w, p, 8);
+                    if ((w - ones) & ~w & (0x80 * ones)) break;
+                }
+                while (*p) ++p;
+                return static_cast<size_t>(p - str);
+            }
+
+            CW_FORCEINLINE size_t length(const wchar_t* str) {
+                size_t n = 0;
+                while (str[n]) ++n;
+                return n;
             }
-            CW_COMPILER_BARRIER();
         }
 
+        inline constexpr uint64_t hash64_seed = 0x5851F42D4C957F2Dull;
+
         template<size_t N>
-        CW_FORCEINLINE void zero_buf(char (&buf)[N]) {
-            volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(buf);
-            for (size_t i = 0; i < N; ++i) p[i] = 0;
-            CW_COMPILER_BARRIER();
+        consteval uint64_t hash64(const char (&str)[N]) {
+            return hash64_detail::hash<false>(str, N - 1, hash64_seed);
+        }
+
+        template<size_t N>
+        consteval uint64_t hash64_ci(const char (&str)[N]) {
+            return hash64_detail::hash<true>(str, N - 1, hash64_seed);
+        }
+
+        CW_FORCEINLINE uint64_t hash64_runtime(const char* str, size_t len) {
+            return hash64_detail::hash<false>(str, len, hash64_seed);
+        }
+
+        CW_FORCEINLINE uint64_t hash64_runtime(const char* str) {
+            return hash64_runtime(str, hash64_detail::length(str));
+        }
+
+        CW_FORCEINLINE uint64_t hash64_runtime_ci(const char* str, size_t len) {
+            return hash64_detail::hash<true>(str, len, hash64_seed);
+        }
+
+        CW_FORCEINLINE uint64_t hash64_runtime_ci(const char* str) {
+            return hash64_runtime_ci(str, hash64_detail::length(str));
+        }
+
+#if !CW_KERNEL_MODE
+        CW_FORCEINLINE uint64_t hash64_runtime(std::string_view str) {
+            return hash64_runtime(str.data(), str.size());
+        }
+
+        CW_FORCEINLINE uint64_t hash64_runtime_ci(std::string_view str) {
+            return hash64_runtime_ci(str.data(), str.size());
+        }
+#endif
+
+        // hashes the low byte of each code unit, for comparing module names against CW_HASH64_CI
+        CW_FORCEINLINE uint64_t hash64_runtime_ci_w2a(const wchar_t* str, size_t len) {
+            return hash64_detail::hash<true>(str, len, hash64_seed);
+        }
+
+        CW_FORCEINLINE uint64_t hash64_runtime_ci_w2a(const wchar_t* str) {
+            return hash64_runtime_ci_w2a(str, hash64_detail::length(str));
+        }
+    }
+
+    #define CW_HASH64(s) ([]() consteval { return cloakwork::hash::hash64(s); }())
+    #define CW_HASH64_CI(s) ([]() consteval { return cloakwork::hash::hash64_ci(s); }())
+
+    //
+    // compile-time perfect hash over CW_HASH keys (hash-and-displace). keys are
+    // split into buckets, and each bucket gets the smallest displacement that
+    // drops all of its keys into free slots, so a lookup is one bucket read, one
+    // slot read and one key compare. the table is the next power of two >= N.
+    // empty slots hold a key that belongs to another slot, so they never match.
+    //
+    namespace hash {
+        namespace perfect_detail {
+            constexpr size_t pow2_at_least(size_t n) {
+                size_t p = 1;
+                while (p < n) p <<= 1;
+                return p;
+            }
+
+            constexpr uint32_t fmix(uint32_t h) {
+                h ^= h >> 16;
+                h *= 0x85EBCA6Bu;
+                h ^= h >> 13;
+                h *= 0xC2B2AE35u;
+                h ^= h >> 16;
+                return h;
+            }
+
+            // not constexpr: reaching either of these fails the build at the call site
+            void duplicate_hash_key();
+            void no_perfect_hash_found();
+        }
+
+        template<size_t N>
+        struct perfect_layout {
+            static_assert(N > 0, "perfect hash needs at least one key");
+            static constexpr size_t slots = perfect_detail::pow2_at_least(N);
+            static constexpr size_t buckets = slots > 1 ? slots / 2 : 1;
+
+            uint32_t keys[slots]{};
+            uint16_t disp[buckets]{};
+
+            static constexpr size_t bucket_of(uint32_t h) {
+                return buckets > 1 ? perfect_detail::fmix(h) & (buckets - 1) : 0;
+            }
+
+            static constexpr size_t slot_of(uint32_t h, uint16_t d) {
+                return perfect_detail::fmix(h ^ (d * 0x9E3779B9u) ^ 0x5BD1E995u) & (slots - 1);
+            }
+
+            CW_FORCEINLINE constexpr size_t index_of(uint32_t h) const {
+                return slot_of(h, disp[bucket_of(h)]);
+            }
+
+            static constexpr size_t size() { return N; }
+
+            // fills keys/disp and reports where each input landed
+            consteval void build(const uint32_t (&in)[N], size_t (&placed)[N]) {
+                for (size_t i = 0; i < N; ++i)
+                    for (size_t j = i + 1; j < N; ++j)
+                        if (in[i] == in[j]) perfect_detail::duplicate_hash_key();
+
+                // keys grouped by bucket: members of bucket b are order[start[b] .. start[b + 1])
+                size_t start[buckets + 1]{};
+                size_t order[N]{};
+                for (size_t i = 0; i < N; ++i) ++start[bucket_of(in[i]) + 1];
+                for (size_t b = 0; b < buckets; ++b) start[b + 1] += start[b];
+                {
+                    size_t fill[buckets]{};
+                    for (size_t i = 0; i < N; ++i) {
+                        size_t b = bucket_of(in[i]);
+                        order[start[b] + fill[b]++] = i;
+                    }
+                }
+
+                bool taken[slots]{};
+                bool done[buckets]{};
+                size_t trial[slots]{};
+                // largest buckets first, they are the hardest to place
+                for (size_t round = 0; round < buckets; ++round) {
+                    size_t b = buckets;
+                    for (size_t i = 0; i < buckets; ++i)
+                        if (!done[i] && (b == buckets ||
+                            start[i + 1] - start[i] > start[b + 1] - start[b])) b = i;
+                    done[b] = true;
+                    if (start[b + 1] == start[b]) break;
+
+                    for (uint32_t d = 0;; ++d) {
+                        if (d > 0xFFFF) perfect_detail::no_perfect_hash_found();
+                        // claim slots as we go and roll back on the first collision
+                        size_t n = 0;
+                        for (size_t k = start[b]; k < start[b + 1]; ++k) {
+                            size_t s = slot_of(in[order[k]], static_cast<uint16_t>(d));
+                            if (taken[s]) break;
+                            taken[s] = true;
+                            trial[n++] = s;
+                        }
+                        if (n != start[b + 1] - start[b]) {
+                            for (size_t k = 0; k < n; ++k) taken[trial[k]] = false;
+                            continue;
+                        }
+
+                        disp[b] = static_cast<uint16_t>(d);
+                        for (size_t k = 0; k < n; ++k) {
+                            keys[trial[k]] = in[order[start[b] + k]];
+                            placed[order[start[b] + k]] = trial[k];
+                        }
+                        break;
+                    }
+                }
+
+                // in[0] lives in its own slot, so as filler it can never match here
+                for (size_t s = 0; s < slots; ++s)
+                    if (!taken[s]) keys[s] = in[0];
+            }
+        };
+
+        template<size_t N>
+        struct hash_set : perfect_layout<N> {
+            CW_FORCEINLINE constexpr bool contains(uint32_t h) const {
+                return this->keys[this->index_of(h)] == h;
+            }
+        };
+
+        template<typename V>
+        struct hash_entry {
+            uint32_t key;
+            V value;
+        };
+
+        template<typename V, size_t N>
+        struct hash_map : perfect_layout<N> {
+            V values[perfect_layout<N>::slots]{};
+
+            // value for h, or nullptr
+            CW_FORCEINLINE constexpr const V* find(uint32_t h) const {
+                size_t i = this->index_of(h);
+                return this->keys[i] == h ? &values[i] : nullptr;
+            }
+
+            CW_FORCEINLINE constexpr bool contains(uint32_t h) const { return find(h) != nullptr; }
+        };
+
+        template<size_t N>
+        consteval hash_set<N> make_hash_set(const uint32_t (&keys)[N]) {
+            hash_set<N> set;
+            size_t placed[N]{};
+            set.build(keys, placed);
+            return set;
+        }
+
+        template<typename V, size_t N>
+        consteval hash_map<V, N> make_hash_map(const hash_entry<V> (&entries)[N]) {
+            hash_map<V, N> map;
+            uint32_t keys[N]{};
+            for (size_t i = 0; i < N; ++i) keys[i] = entries[i].key;
+            size_t placed[N]{};
+            map.build(keys, placed);
+            for (size_t i = 0; i < N; ++i) map.values[placed[i]] = entries[i].value;
+            return map;
+        }
+    }
+
+    // usage: static constexpr auto tools = CW_HASH_SET(CW_HASH_CI("x64dbg.exe"), CW_HASH_CI("ida64.exe"));
+    //        if (tools.contains(hash::fnv1a_runtime_ci(name))) ...
+    #define CW_HASH_SET(...) \
+        ([]() consteval { return cloakwork::hash::make_hash_set({ __VA_ARGS__ }); }())
+
+    // usage: static constexpr auto cmds = CW_HASH_MAP(handler_fn, { CW_HASH("stop"), &on_stop }, { CW_HASH("start"), &on_start });
+    //        if (auto fn = cmds.find(hash::fnv1a_runtime(name))) (*fn)();
+    #define CW_HASH_MAP(V, ...) \
+        ([]() consteval { return cloakwork::hash::make_hash_map<V>({ __VA_ARGS__ }); }())
+
+    //
+    // platform-independent PE parsing over a byte range. nothing here uses the
+    // windows headers, so the same code reads live modules on windows and PE
+    // files loaded as buffers anywhere else (benchmarks, offline tooling).
+    // every read is bounds-checked against the range it was given.
+    //
+    namespace pe {
+
+        // mapped: RVAs are offsets (a loaded module). file: RVAs go through the section table
+        enum class layout { mapped, file };
+
+        namespace detail {
+            template<typename T>
+            CW_FORCEINLINE T read(const uint8_t* p) {
+                T v;
+                memcpy(&v, p, sizeof(T));
+                return v;
+            }
+
+            inline constexpr uint16_t dos_magic = 0x5A4D;      // "MZ"
+            inline constexpr uint32_t nt_signature = 0x4550;   // "PE\0\0"
+            inline constexpr uint16_t pe32_magic = 0x10B;
+            inline constexpr uint16_t pe32plus_magic = 0x20B;
+            inline constexpr uint32_t section_header_size = 40;
+            inline constexpr uint32_t export_directory_size = 40;
+            inline constexpr uint32_t scn_mem_execute = 0x20000000;
+        }
+
+        struct section {
+            const char* name;  // up to 8 bytes, unterminated when all 8 are used
+            uint32_t virtual_address;
+            uint32_t virtual_size;
+            uint32_t raw_size;
+            uint32_t raw_pointer;
+            uint32_t characteristics;
+
+            size_t name_length() const {
+                size_t n = 0;
+                while (n < 8 && name[n]) ++n;
+                return n;
+            }
+
+            bool executable() const { return (characteristics & detail::scn_mem_execute) != 0; }
+        };
+
+        // the section table, read in place
+        class section_range {
+        public:
+            class iterator {
+            public:
+                explicit iterator(const uint8_t* at) : at_(at) {}
+
+                section operator*() const {
+                    return { reinterpret_cast<const char*>(at_),
+                             detail::read<uint32_t>(at_ + 12), detail::read<uint32_t>(at_ + 8),
+                             detail::read<uint32_t>(at_ + 16), detail::read<uint32_t>(at_ + 20),
+                             detail::read<uint32_t>(at_ + 36) };
+                }
+
+                iterator& operator++() {
+                    at_ += detail::section_header_size;
+                    return *this;
+                }
+
+                bool operator!=(const iterator& other) const { return at_ != other.at_; }
+
+            private:
+                const uint8_t* at_;
+            };
+
+            section_range() = default;
+            section_range(const uint8_t* first, uint16_t count) : first_(first), count_(count) {}
+
+            iterator begin() const { return iterator(first_); }
+            iterator end() const { return iterator(first_ + count_ * detail::section_header_size); }
+            uint16_t size() const { return count_; }
+
+        private:
+            const uint8_t* first_ = nullptr;
+            uint16_t count_ = 0;
+        };
+
+        class export_range;
+
+        class image_view {
+        public:
+            image_view() = default;
+
+            // parses the headers of [data, data + size). on failure the view stays empty
+            bool parse(const void* data, size_t size, layout kind = layout::mapped) {
+                *this = image_view{};
+                auto p = static_cast<const uint8_t*>(data);
+                if (!p || size < 0x40) return false;
+                if (detail::read<uint16_t>(p) != detail::dos_magic) return false;
+
+                uint32_t nt = detail::read<uint32_t>(p + 0x3C);
+                if (nt == 0 || nt >= 0x1000 || static_cast<uint64_t>(nt) + 24 > size) return false;
+                if (detail::read<uint32_t>(p + nt) != detail::nt_signature) return false;
+
+                uint16_t section_count = detail::read<uint16_t>(p + nt + 6);
+                uint16_t opt_size = detail::read<uint16_t>(p + nt + 20);
+                uint32_t opt = nt + 24;
+                if (static_cast<uint64_t>(opt) + opt_size > size || opt_size < 2) return false;
+
+                uint16_t magic = detail::read<uint16_t>(p + opt);
+                uint32_t dirs_at;
+                if (magic == detail::pe32_magic) dirs_at = 96;
+                else if (magic == detail::pe32plus_magic) dirs_at = 112;
+                else return false;
+                if (opt_size < dirs_at) return false;
+
+                uint32_t image_size = detail::read<uint32_t>(p + opt + 56);
+                if (image_size == 0 || image_size > 0x7FFFFFFF) return false;
+
+                uint32_t sections = opt + opt_size;
+                if (static_cast<uint64_t>(sections) + static_cast<uint64_t>(section_count) *
+                    detail::section_header_size > size) return false;
+
+                uint32_t dir_count = detail::read<uint32_t>(p + opt + dirs_at - 4);
+                if (dir_count > 0 && opt_size >= dirs_at + 8) {
+                    export_rva_ = detail::read<uint32_t>(p + opt + dirs_at);
+                    export_size_ = detail::read<uint32_t>(p + opt + dirs_at + 4);
+                }
+
+                data_ = p;
+                size_ = size;
+                kind_ = kind;
+                image_size_ = image_size;
+                headers_size_ = detail::read<uint32_t>(p + opt + 60);
+                sections_ = sections;
+                section_count_ = section_count;
+                return true;
+            }
+
+            // a module mapped by the loader, trusted to be SizeOfImage long
+            bool parse_module(const void* base) {
+                if (!parse(base, static_cast<size_t>(-1), layout::mapped)) return false;
+                size_ = image_size_;
+                return true;
+            }
+
+            bool valid() const { return data_ != nullptr; }
+            const uint8_t* data() const { return data_; }
+            size_t size() const { return size_; }
+            layout kind() const { return kind_; }
+            uint32_t image_size() const { return image_size_; }
+            uint32_t export_rva() const { return export_rva_; }
+            uint32_t export_size() const { return export_size_; }
+
+            section_range sections() const {
+                return data_ ? section_range(data_ + sections_, section_count_) : section_range();
+            }
+
+            // named exports in name table order; empty if there is no usable export directory
+            export_range exports() const;
+
+            bool in_export_directory(uint32_t rva) const {
+                return rva >= export_rva_ &&
+                    static_cast<uint64_t>(rva) < static_cast<uint64_t>(export_rva_) + export_size_;
+            }
+
+            // bytes readable from rva to the end of whatever holds it (0 if unmapped)
+            size_t available(uint32_t rva) const {
+                size_t off;
+                size_t limit;
+                if (!translate(rva, off, limit)) return 0;
+                return limit - off;
+            }
+
+            // pointer to [rva, rva + len), or nullptr if any of it is out of bounds
+            const uint8_t* at(uint32_t rva, size_t len) const {
+                size_t off;
+                size_t limit;
+                if (!translate(rva, off, limit) || len > limit - off) return nullptr;
+                return data_ + off;
+            }
+
+        private:
+            // rva -> buffer offset, plus the end offset of the region it lies in
+            bool translate(uint32_t rva, size_t& off, size_t& limit) const {
+                if (!data_ || rva >= image_size_) return false;
+                if (kind_ == layout::mapped) {
+                    if (rva >= size_) return false;
+                    off = rva;
+                    limit = size_ < image_size_ ? size_ : image_size_;
+                    return true;
+                }
+                for (uint16_t i = 0; i < section_count_; ++i) {
+                    const uint8_t* sh = data_ + sections_ + i * detail::section_header_size;
+                    uint32_t va = detail::read<uint32_t>(sh + 12);
+                    uint32_t raw_size = detail::read<uint32_t>(sh + 16);
+                    uint32_t raw_ptr = detail::read<uint32_t>(sh + 20);
+                    if (rva < va || rva - va >= raw_size) continue;
+                    uint64_t end = static_cast<uint64_t>(raw_ptr) + raw_size;
+                    if (end > size_) end = size_;
+                    off = static_cast<size_t>(raw_ptr) + (rva - va);
+                    limit = static_cast<size_t>(end);
+                    return off < limit;
+                }
+                // headers are stored at the same offsets in both layouts
+                size_t headers_end = headers_size_ < size_ ? headers_size_ : size_;
+                if (rva >= headers_end) return false;
+                off = rva;
+                limit = headers_end;
+                return true;
+            }
+
+            const uint8_t* data_ = nullptr;
+            size_t size_ = 0;
+            layout kind_ = layout::mapped;
+            uint32_t image_size_ = 0;
+            uint32_t headers_size_ = 0;
+            uint32_t sections_ = 0;
+            uint16_t section_count_ = 0;
+            uint32_t export_rva_ = 0;
+            uint32_t export_size_ = 0;
+        };
+
+        struct export_symbol {
+            const char* name;  // nullptr if the name RVA is out of bounds
+            size_t name_max;   // bytes readable at name; a well-formed name ends in a NUL within them
+            uint32_t rva;      // 0 if the ordinal is out of range
+            uint16_t ordinal;  // index into the function table (not biased by the directory's Base)
+            bool forwarded;    // rva points at a "dll.function" string, not code
+        };
+
+        // the export name, ordinal and function tables, bounds-checked once up front
+        class export_range {
+        public:
+            class iterator {
+            public:
+                iterator(const export_range* range, uint32_t i) : range_(range), i_(i) {}
+                export_symbol operator*() const { return (*range_)[i_]; }
+
+                iterator& operator++() {
+                    ++i_;
+                    return *this;
+                }
+
+                bool operator!=(const iterator& other) const { return i_ != other.i_; }
+
+            private:
+                const export_range* range_;
+                uint32_t i_;
+            };
+
+            export_range() = default;
+
+            explicit export_range(const image_view& img) {
+                if (!img.valid() || img.export_rva() == 0) return;
+                const uint8_t* dir = img.at(img.export_rva(), detail::export_directory_size);
+                if (!dir) return;
+                uint32_t function_count = detail::read<uint32_t>(dir + 20);
+                uint32_t name_count = detail::read<uint32_t>(dir + 24);
+                functions_ = img.at(detail::read<uint32_t>(dir + 28), function_count * size_t{4});
+                names_ = img.at(detail::read<uint32_t>(dir + 32), name_count * size_t{4});
+                ordinals_ = img.at(detail::read<uint32_t>(dir + 36), name_count * size_t{2});
+                if (!functions_ || !names_ || !ordinals_) return;
+                img_ = &img;
+                function_count_ = function_count;
+                name_count_ = name_count;
+            }
+
+            bool valid() const { return img_ != nullptr; }
+            uint32_t size() const { return name_count_; }
+            uint32_t function_count() const { return function_count_; }
+
+            iterator begin() const { return iterator(this, 0); }
+            iterator end() const { return iterator(this, name_count_); }
+
+            // the name alone, for scans that only need the rest on a match
+            const char* name(uint32_t i, size_t& max) const {
+                uint32_t name_rva = detail::read<uint32_t>(names_ + i * 4);
+                auto p = reinterpret_cast<const char*>(img_->at(name_rva, 1));
+                max = p ? img_->available(name_rva) : 0;
+                return p;
+            }
+
+            export_symbol operator[](uint32_t i) const {
+                export_symbol sym{};
+                sym.name = name(i, sym.name_max);
+                sym.ordinal = detail::read<uint16_t>(ordinals_ + i * 2);
+                if (sym.ordinal < function_count_) {
+                    sym.rva = detail::read<uint32_t>(functions_ + sym.ordinal * 4);
+                    sym.forwarded = img_->in_export_directory(sym.rva);
+                }
+                return sym;
+            }
+
+        private:
+            const image_view* img_ = nullptr;
+            const uint8_t* functions_ = nullptr;
+            const uint8_t* names_ = nullptr;
+            const uint8_t* ordinals_ = nullptr;
+            uint32_t function_count_ = 0;
+            uint32_t name_count_ = 0;
+        };
+
+        inline export_range image_view::exports() const {
+            return export_range(*this);
+        }
+
+        // RVA exported under fnv1a name hash h, or 0. a plain scan that allocates
+        // nothing; see export_index for repeated lookups in one module
+        inline uint32_t find_export(const image_view& img, uint32_t h) {
+            export_range exports = img.exports();
+            for (uint32_t i = 0; i < exports.size(); ++i) {
+                size_t max;
+                const char* name = exports.name(i, max);
+                if (name && hash::fnv1a_runtime_bounded(name, max) == h) return exports[i].rva;
+            }
+            return 0;
+        }
+
+        //
+        // compile-time lists of export names. CW_IMPORT_SET passes its names as a
+        // single stringized "A, B, C" list, which is split and hashed here so the
+        // macro needs no per-argument expansion.
+        //
+        template<size_t N>
+        struct export_names {
+            uint32_t hashes[N];
+        };
+
+        namespace detail {
+            consteval bool name_space(char c) {
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }
+        }
+
+        consteval size_t count_export_names(const char* list) {
+            size_t n = 1;
+            for (; *list; ++list)
+                if (*list == ',') ++n;
+            return n;
+        }
+
+        template<size_t N>
+        consteval export_names<N> hash_export_names(const char* list) {
+            export_names<N> out{};
+            for (size_t i = 0; i < N; ++i) {
+                while (detail::name_space(*list)) ++list;
+                size_t len = 0;
+                while (list[len] && list[len] != ',' && !detail::name_space(list[len])) ++len;
+                out.hashes[i] = hash::fnv1a(list, len);
+                list += len;
+                while (*list && *list != ',') ++list;
+                if (*list) ++list;
+            }
+            return out;
+        }
+
+        // perfect hash from each name's hash to its position in the list
+        template<size_t N>
+        consteval hash::hash_map<uint16_t, N> export_name_positions(const export_names<N>& names) {
+            hash::hash_entry<uint16_t> entries[N]{};
+            for (size_t i = 0; i < N; ++i) entries[i] = { names.hashes[i], static_cast<uint16_t>(i) };
+            return hash::make_hash_map<uint16_t>(entries);
+        }
+
+        //
+        // resolves a whole set of names in one pass over the export name table:
+        // each name is hashed once and checked with a single perfect-hash probe,
+        // and the scan stops once every wanted name has been seen. rvas[i] gets
+        // the RVA exported as wanted position i, or 0. returns how many were found
+        //
+        template<size_t N>
+        inline size_t resolve_exports(const image_view& img, const hash::hash_map<uint16_t, N>& wanted,
+                                      uint32_t (&rvas)[N]) {
+            for (auto& r : rvas) r = 0;
+            export_range exports = img.exports();
+
+            size_t found = 0;
+            for (uint32_t i = 0; i < exports.size() && found < N; ++i) {
+                size_t max;
+                const char* name = exports.name(i, max);
+                if (!name) continue;
+                const uint16_t* pos = wanted.find(hash::fnv1a_runtime_bounded(name, max));
+                if (!pos || rvas[*pos]) continue;
+                uint32_t rva = exports[i].rva;
+                if (rva == 0) continue;
+                rvas[*pos] = rva;
+                ++found;
+            }
+            return found;
+        }
+
+#if !CW_KERNEL_MODE
+        //
+        // open-addressed table of (fnv1a name hash -> export RVA), built with one
+        // pass over the export name table. a lookup is one probe in the common
+        // case instead of hashing every name. RVAs inside the export directory
+        // are forwarder strings (see image_view::in_export_directory). if two
+        // names share a hash, the first in name order wins, as in a linear scan.
+        //
+        class export_index {
+        public:
+            struct entry {
+                uint32_t hash;
+                uint32_t rva;  // 0 = empty slot; no real export lives at rva 0
+            };
+
+            bool build(const image_view& img) {
+                slots_.reset();
+                mask_ = 0;
+                count_ = 0;
+                export_range exports = img.exports();
+                if (!exports.valid()) return false;
+
+                // load factor <= 1/2 keeps probe chains short
+                size_t capacity = 8;
+                while (capacity < static_cast<size_t>(exports.size()) * 2) capacity <<= 1;
+                slots_.reset(new (std::nothrow) entry[capacity]{});
+                if (!slots_) return false;
+                mask_ = static_cast<uint32_t>(capacity - 1);
+
+                for (const export_symbol& sym : exports)
+                    if (sym.name && sym.rva)
+                        insert(hash::fnv1a_runtime_bounded(sym.name, sym.name_max), sym.rva);
+                return true;
+            }
+
+            // RVA exported under name hash h, or 0
+            CW_FORCEINLINE uint32_t find(uint32_t h) const {
+                if (!slots_) return 0;
+                for (uint32_t i = slot_of(h);; i = (i + 1) & mask_) {
+                    const entry& e = slots_[i];
+                    if (e.rva == 0) return 0;
+                    if (e.hash == h) return e.rva;
+                }
+            }
+
+            uint32_t size() const { return count_; }
+
+        private:
+            CW_FORCEINLINE uint32_t slot_of(uint32_t h) const {
+                // fnv1a's low bits are weak on short names, so fold the high half in
+                return (h ^ (h >> 16)) & mask_;
+            }
+
+            void insert(uint32_t h, uint32_t rva) {
+                for (uint32_t i = slot_of(h);; i = (i + 1) & mask_) {
+                    entry& e = slots_[i];
+                    if (e.rva == 0) {
+                        e = { h, rva };
+                        ++count_;
+                        return;
+                    }
+                    if (e.hash == h) return;
+                }
+            }
+
+            std::unique_ptr<entry[]> slots_;
+            uint32_t mask_ = 0;
+            uint32_t count_ = 0;
+        };
+#endif
+    }
+
+    namespace internal_cipher {
+
+        //
+        // position-dependent xor cipher to prevent Hex-Rays stack-string reconstruction.
+        // mix constants are derived from the Key so each stub has unique imul operands
+        // and shift widths — prevents pattern scanning for fixed magic values.
+        //
+        template<uint32_t Key>
+        struct cipher_params {
+            static constexpr uint32_t mix_a = 0x9E3779B9u ^ (Key * 0x01000193u);
+            static constexpr uint32_t mix_b = 0x45D9F3Bu ^ ((Key >> 7) * 0x27D4EB2Du);
+            static constexpr uint32_t shift_a = 13u + (Key & 3u);
+            static constexpr uint32_t shift_b = 11u + ((Key >> 2) & 3u);
+            static constexpr bool extra_round = (Key & 0x10u) != 0;
+
+            // turns i * mix_a into the subkey for position i. V is uint32_t or a
+            // simd lane type, so the stack decrypt can run 4 positions per vector
+            template<typename V>
+            static constexpr CW_FORCEINLINE void subkey(V& s) {
+                s ^= Key;
+                s ^= s >> shift_a;
+                s = s * mix_b;
+                s ^= s >> shift_b;
+                if constexpr (extra_round) {
+                    s ^= s >> 7;
+                    s = s * (0x119DE1F3u ^ (Key >> 16));
+                }
+            }
+        };
+
+        template<uint32_t Key, size_t N>
+        struct encrypted_buf {
+            uint8_t data[N];
+
+            consteval encrypted_buf(const char (&str)[N]) : data{} {
+                using P = cipher_params<Key>;
+                for (size_t i = 0; i < N; ++i) {
+                    uint32_t subkey = static_cast<uint32_t>(i) * P::mix_a;
+                    P::subkey(subkey);
+                    data[i] = static_cast<uint8_t>(str[i]) ^ static_cast<uint8_t>(subkey);
+                }
+            }
+        };
+
+        template<uint32_t Key, size_t N>
+        CW_NOINLINE void decrypt_to_stack(const encrypted_buf<Key, N>& enc, char (&out)[N]) {
+            using P = cipher_params<Key>;
+            // laundered so the subkeys are computed here with the per-key imul
+            // operands, rather than folded into plaintext stores
+            const uint8_t* src = enc.data;
+            uint32_t first = 0;
+            CW_LAUNDER(src);
+            CW_LAUNDER(first);
+            size_t i = 0;
+#if CW_SIMD
+            uint8_t* dst = reinterpret_cast<uint8_t*>(out);
+            simd::u32x4 scaled = (simd::lane_index() + first) * P::mix_a;
+            const uint32_t step = 4u * P::mix_a;
+            for (; i + 16 <= N; i += 16) {
+                simd::u32x4 a = scaled, b = scaled + step, c = scaled + 2u * step, d = scaled + 3u * step;
+                P::subkey(a);
+                P::subkey(b);
+                P::subkey(c);
+                P::subkey(d);
+                scaled += 4u * step;
+                memcpy(dst + i, src + i, 16);
+                simd::xor_bytes(dst + i, simd::low_bytes(a, b, c, d));
+            }
+            for (; i + 4 <= N; i += 4) {
+                simd::u32x4 a = scaled;
+                P::subkey(a);
+                scaled += step;
+                memcpy(dst + i, src + i, 4);
+                simd::xor_bytes(dst + i, simd::low_bytes(a));
+            }
+#endif
+            volatile uint8_t* tail = reinterpret_cast<volatile uint8_t*>(out);
+            for (; i < N; ++i) {
+                uint32_t subkey = static_cast<uint32_t>(i + first) * P::mix_a;
+                P::subkey(subkey);
+                tail[i] = src[i] ^ static_cast<uint8_t>(subkey);
+            }
+            CW_COMPILER_BARRIER();
+        }
+
+        template<size_t N>
+        CW_FORCEINLINE void zero_buf(char (&buf)[N]) {
+            volatile uint8_t* p = reinterpret_cast<volatile uint8_t*>(buf);
+            for (size_t i = 0; i < N; ++i) p[i] = 0;
+            CW_COMPILER_BARRIER();
         }
 
         // avoids strstr IAT entry
@@ -1233,7 +2691,10 @@ namespace cloakwork {
         // self-contained module/proc resolution that avoids IAT entries
         namespace detail {
 
-            CW_FORCEINLINE void* get_module_by_hash(uint32_t module_hash) {
+            // walks the loader list once and returns the first module whose
+            // case-insensitive name hash satisfies match
+            template<typename Match>
+            CW_FORCEINLINE void* find_module(Match match) {
 #if defined(_WIN32) && !CW_KERNEL_MODE
                 __try {
 #ifdef _WIN64
@@ -1248,58 +2709,48 @@ namespace cloakwork {
                     for (auto curr = head->Flink; curr != head; curr = curr->Flink) {
                         auto entry = CONTAINING_RECORD(curr, cloakwork_internal::CW_LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
                         if (!entry->BaseDllName.Buffer || entry->BaseDllName.Length == 0) continue;
-                        if (hash::fnv1a_runtime_ci_w2a(entry->BaseDllName.Buffer) == module_hash)
+                        if (match(hash::fnv1a_runtime_ci_w2a(entry->BaseDllName)))
                             return entry->DllBase;
                     }
                 }
                 __except (EXCEPTION_EXECUTE_HANDLER) {
                     return nullptr;
                 }
+#else
+                (void)match;
 #endif
                 return nullptr;
             }
 
+            CW_FORCEINLINE void* get_module_by_hash(uint32_t module_hash) {
+                return find_module([module_hash](uint32_t h) { return h == module_hash; });
+            }
+
             CW_FORCEINLINE bool is_module_loaded(uint32_t module_hash) {
                 return get_module_by_hash(module_hash) != nullptr;
             }
 
+            // true if any loaded module is in the CW_HASH_SET, in a single list walk
+            template<typename Set>
+            CW_FORCEINLINE bool any_module_loaded(const Set& modules) {
+                return find_module([&modules](uint32_t h) { return modules.contains(h); }) != nullptr;
+            }
+
             CW_FORCEINLINE void* get_proc_by_hash(void* module, uint32_t func_hash) {
 #if defined(_WIN32) && !CW_KERNEL_MODE
                 if (!module) return nullptr;
                 __try {
-                    auto dos = static_cast<IMAGE_DOS_HEADER*>(module);
-                    if (dos->e_magic != IMAGE_DOS_SIGNATURE) return nullptr;
-                    if (dos->e_lfanew <= 0 || dos->e_lfanew >= 0x1000) return nullptr;
-
-                    auto nt = reinterpret_cast<IMAGE_NT_HEADERS*>(
-                        reinterpret_cast<uint8_t*>(module) + dos->e_lfanew);
-                    if (nt->Signature != IMAGE_NT_SIGNATURE) return nullptr;
-
-                    uint32_t image_size = nt->OptionalHeader.SizeOfImage;
-                    if (image_size == 0 || image_size > 0x7FFFFFFF) return nullptr;
-
-                    auto& exp_dir = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
-                    if (exp_dir.VirtualAddress == 0 || exp_dir.Size == 0) return nullptr;
-
-                    auto base = reinterpret_cast<uint8_t*>(module);
-                    auto exports = reinterpret_cast<IMAGE_EXPORT_DIRECTORY*>(base + exp_dir.VirtualAddress);
-
-                    auto names     = reinterpret_cast<uint32_t*>(base + exports->AddressOfNames);
-                    auto ordinals  = reinterpret_cast<uint16_t*>(base + exports->AddressOfNameOrdinals);
-                    auto functions = reinterpret_cast<uint32_t*>(base + exports->AddressOfFunctions);
-
-                    for (uint32_t i = 0; i < exports->NumberOfNames; ++i) {
-                        auto name = reinterpret_cast<const char*>(base + names[i]);
-                        if (hash::fnv1a_runtime(name) == func_hash) {
-                            uint16_t ordinal = ordinals[i];
-                            if (ordinal >= exports->NumberOfFunctions) return nullptr;
-                            return base + functions[ordinal];
-                        }
-                    }
+                    pe::image_view img;
+                    if (!img.parse_module(module)) return nullptr;
+                    uint32_t rva = pe::find_export(img, func_hash);
+                    if (rva) return static_cast<uint8_t*>(module) + rva;
                 }
                 __except (EXCEPTION_EXECUTE_HANDLER) {
                     return nullptr;
                 }
+#else
+                (void)module;
+                (void)func_hash;
 #endif
                 return nullptr;
             }
@@ -1460,6 +2911,8 @@ namespace cloakwork {
 
             return false;
 #else
+            (void)func;
+            (void)threshold;
             return false;
 #endif
         }
@@ -1542,17 +2995,14 @@ namespace cloakwork {
                 return false;
 #elif defined(_WIN32)
                 __try {
-                    constexpr uint32_t hiding_dll_hashes[] = {
+                    static constexpr auto hiding_dlls = CW_HASH_SET(
                         CW_HASH_CI("scylla_hide.dll"),
                         CW_HASH_CI("ScyllaHideX64.dll"),
                         CW_HASH_CI("ScyllaHideX86.dll"),
                         CW_HASH_CI("TitanHide.dll"),
-                        CW_HASH_CI("HyperHide.dll"),
-                    };
+                        CW_HASH_CI("HyperHide.dll"));
 
-                    for (auto h : hiding_dll_hashes) {
-                        if (detail::is_module_loaded(h)) return true;
-                    }
+                    if (detail::any_module_loaded(hiding_dlls)) return true;
 
                     auto user32 = detail::get_module_by_hash(CW_HASH_CI("user32.dll"));
                     if (!user32) return false;
@@ -1562,31 +3012,27 @@ namespace cloakwork {
                     auto pGetClassNameA = reinterpret_cast<int(WINAPI*)(HWND, LPSTR, int)>(
                         detail::get_proc_by_hash(user32, CW_HASH("GetClassNameA")));
                     if (pEnumWindows && pGetClassNameA) {
-                        constexpr uint32_t dbg_class_hashes[] = {
+                        static constexpr auto dbg_classes = CW_HASH_SET(
                             CW_HASH("OLLYDBG"),
                             CW_HASH("WinDbgFrameClass"),
                             CW_HASH("ID"),
-                            CW_HASH("ObsidianGUI"),
-                        };
+                            CW_HASH("ObsidianGUI"));
                         struct enum_ctx {
                             bool found;
-                            const uint32_t* class_hashes;
-                            size_t class_count;
+                            const decltype(dbg_classes)* classes;
                             decltype(pGetClassNameA) getClassName;
                         };
 
-                        enum_ctx ctx = {
-                            false, dbg_class_hashes, sizeof(dbg_class_hashes)/sizeof(uint32_t),
-                            pGetClassNameA
-                        };
+                        enum_ctx ctx = { false, &dbg_classes, pGetClassNameA };
 
                         pEnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
                             auto* c = reinterpret_cast<enum_ctx*>(lParam);
                             char buf[256];
                             if (c->getClassName(hwnd, buf, sizeof(buf))) {
-                                uint32_t h = hash::fnv1a_runtime(buf);
-                                for (size_t i = 0; i < c->class_count; ++i)
-                                    if (h == c->class_hashes[i]) { c->found = true; return FALSE; }
+                                if (c->classes->contains(hash::fnv1a_runtime(buf))) {
+                                    c->found = true;
+                                    return FALSE;
+                                }
                             }
                             return TRUE;
                         }, reinterpret_cast<LPARAM>(&ctx));
@@ -1701,7 +3147,7 @@ namespace cloakwork {
 
                     // find parent process name and compare via hash (no plaintext exe names)
                     if (parent_pid) {
-                        constexpr uint32_t suspicious_parent_hashes[] = {
+                        static constexpr auto suspicious_parents = CW_HASH_SET(
                             CW_HASH_CI("x64dbg.exe"),
                             CW_HASH_CI("x32dbg.exe"),
                             CW_HASH_CI("x86dbg.exe"),
@@ -1712,19 +3158,15 @@ namespace cloakwork {
                             CW_HASH_CI("immunitydebugger.exe"),
                             CW_HASH_CI("cheatengine-x86_64.exe"),
                             CW_HASH_CI("cheatengine-i386.exe"),
-                            CW_HASH_CI("processhacker.exe"),
-                        };
+                            CW_HASH_CI("processhacker.exe"));
 
                         pe.dwSize = sizeof(PROCESSENTRY32W);
                         if (pProcess32FirstW(snapshot, &pe)) {
                             do {
                                 if (pe.th32ProcessID == parent_pid) {
-                                    uint32_t name_hash = hash::fnv1a_runtime_ci_w2a(pe.szExeFile);
-                                    for (auto h : suspicious_parent_hashes) {
-                                        if (name_hash == h) {
-                                            CloseHandle(snapshot);
-                                            return true;
-                                        }
+                                    if (suspicious_parents.contains(hash::fnv1a_runtime_ci_w2a(pe.szExeFile))) {
+                                        CloseHandle(snapshot);
+                                        return true;
                                     }
                                     break;
                                 }
@@ -1743,6 +3185,7 @@ namespace cloakwork {
 
             CW_FORCEINLINE bool detect_memory_breakpoints(void* address, size_t size) {
 #if CW_KERNEL_MODE
+                (void)size;
                 if (!MmIsAddressValid(address)) return false;
                 return false;
 
@@ -1763,6 +3206,9 @@ namespace cloakwork {
                     ptr += block_size;
                     remaining -= block_size;
                 }
+#else
+                (void)address;
+                (void)size;
 #endif
                 return false;
             }
@@ -1872,7 +3318,7 @@ namespace cloakwork {
         }
 
         CW_FORCEINLINE bool comprehensive_check() {
-            __try {
+            CW_SEH_TRY {
                 if (is_debugger_present()) return true;
                 if (has_hardware_breakpoints()) return true;
 
@@ -1888,21 +3334,21 @@ namespace cloakwork {
 
                 if (timing_suspicious) return true;
 
-                __try {
+                CW_SEH_TRY {
                     if (advanced::detect_hiding_tools()) return true;
-                } __except (EXCEPTION_EXECUTE_HANDLER) {}
+                } CW_SEH_EXCEPT {}
 
-                __try {
+                CW_SEH_TRY {
                     if (advanced::kernel_debugger_present()) return true;
-                } __except (EXCEPTION_EXECUTE_HANDLER) {}
+                } CW_SEH_EXCEPT {}
 
-                __try {
+                CW_SEH_TRY {
                     if (advanced::suspicious_parent_process()) return true;
-                } __except (EXCEPTION_EXECUTE_HANDLER) {}
+                } CW_SEH_EXCEPT {}
 
                 return false;
             }
-            __except (EXCEPTION_EXECUTE_HANDLER) {
+            CW_SEH_EXCEPT {
                 return false;
             }
         }
@@ -1910,7 +3356,7 @@ namespace cloakwork {
         CW_FORCEINLINE void inline_check() {
 #if CW_ANTI_DEBUG_RESPONSE == 1
             if (is_debugger_present() || has_hardware_breakpoints()) {
-                __debugbreak();
+                intrin::debug_break();
                 *(volatile int*)0 = 0;
             }
 #elif CW_ANTI_DEBUG_RESPONSE == 2
@@ -1925,7 +3371,7 @@ namespace cloakwork {
             CW_FORCEINLINE bool is_hypervisor_present() {
 #if defined(_WIN32)
                 int cpuInfo[4];
-                __cpuid(cpuInfo, 1);
+                intrin::cpuid(cpuInfo, 1);
                 return (cpuInfo[2] >> 31) & 1;  // hypervisor bit
 #else
                 return false;
@@ -1994,7 +3440,7 @@ namespace cloakwork {
             CW_FORCEINLINE bool detect_sandbox_dlls() {
 #if defined(_WIN32) && !CW_KERNEL_MODE
                 __try {
-                    constexpr uint32_t sandbox_dll_hashes[] = {
+                    static constexpr auto sandbox_dlls = CW_HASH_SET(
                         CW_HASH_CI("SbieDll.dll"),       // sandboxie
                         CW_HASH_CI("api_log.dll"),       // api logging
                         CW_HASH_CI("dir_watch.dll"),     // directory watching
@@ -2003,12 +3449,9 @@ namespace cloakwork {
                         CW_HASH_CI("wpespy.dll"),        // wpe pro
                         CW_HASH_CI("cmdvrt32.dll"),      // comodo sandbox
                         CW_HASH_CI("cmdvrt64.dll"),      // comodo sandbox
-                        CW_HASH_CI("cuckoomon.dll"),     // cuckoo sandbox
-                    };
+                        CW_HASH_CI("cuckoomon.dll"));   // cuckoo sandbox
 
-                    for (auto h : sandbox_dll_hashes) {
-                        if (detail::is_module_loaded(h)) return true;
-                    }
+                    if (detail::any_module_loaded(sandbox_dlls)) return true;
 
                     auto user32 = detail::get_module_by_hash(CW_HASH_CI("user32.dll"));
                     if (user32) {
@@ -2018,30 +3461,28 @@ namespace cloakwork {
                             detail::get_proc_by_hash(user32, CW_HASH("GetClassNameA")));
 
                         if (pEnumWindows && pGetClassNameA) {
-                            constexpr uint32_t tool_class_hashes[] = {
+                            static constexpr auto tool_classes = CW_HASH_SET(
                                 CW_HASH("PROCMON_WINDOW_CLASS"),
                                 CW_HASH("FilemonClass"),
                                 CW_HASH("RegmonClass"),
-                                CW_HASH("Autoruns"),
-                            };
+                                CW_HASH("Autoruns"));
 
                             struct sb_enum_ctx {
                                 bool found;
-                                const uint32_t* hashes;
-                                size_t count;
+                                const decltype(tool_classes)* classes;
                                 decltype(pGetClassNameA) getClassName;
                             };
 
-                            sb_enum_ctx ctx = { false, tool_class_hashes,
-                                sizeof(tool_class_hashes)/sizeof(uint32_t), pGetClassNameA };
+                            sb_enum_ctx ctx = { false, &tool_classes, pGetClassNameA };
 
                             pEnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL {
                                 auto* c = reinterpret_cast<sb_enum_ctx*>(lParam);
                                 char buf[256];
                                 if (c->getClassName(hwnd, buf, sizeof(buf))) {
-                                    uint32_t h = hash::fnv1a_runtime(buf);
-                                    for (size_t i = 0; i < c->count; ++i)
-                                        if (h == c->hashes[i]) { c->found = true; return FALSE; }
+                                    if (c->classes->contains(hash::fnv1a_runtime(buf))) {
+                                        c->found = true;
+                                        return FALSE;
+                                    }
                                 }
                                 return TRUE;
                             }, reinterpret_cast<LPARAM>(&ctx));
@@ -2211,7 +3652,7 @@ namespace cloakwork {
             }
 
             CW_FORCEINLINE bool comprehensive_check() {
-                __try {
+                CW_SEH_TRY {
                     return is_hypervisor_present() ||
                         detect_vm_vendor() ||
                         detect_low_resources() ||
@@ -2221,7 +3662,7 @@ namespace cloakwork {
                         detect_vm_mac();
                 }
 
-                __except (EXCEPTION_EXECUTE_HANDLER) {
+                CW_SEH_EXCEPT {
                     return false;
                 }
             }
@@ -2232,7 +3673,7 @@ namespace cloakwork {
     #define CW_ANTI_DEBUG() \
         do { \
             if(cloakwork::anti_debug::comprehensive_check()) { \
-                __debugbreak(); \
+                cloakwork::intrin::debug_break(); \
                 *(volatile int*)0 = 0; \
             } \
         } while(0)
@@ -2241,7 +3682,7 @@ namespace cloakwork {
         #define CW_ANTI_VM() \
             do { \
                 if(cloakwork::anti_debug::anti_vm::comprehensive_check()) { \
-                    __debugbreak(); \
+                    cloakwork::intrin::debug_break(); \
                     *(volatile int*)0 = 0; \
                 } \
             } while(0)
@@ -2366,8 +3807,10 @@ namespace cloakwork {
                 }
             }
 
-            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
-            static constexpr void decrypt_block(uint32_t& v0, uint32_t& v1) {
+            // V is uint32_t or a simd lane type; the key schedule stays scalar and
+            // broadcasts, so one instantiation decrypts sizeof(V)/4 blocks at once
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename V = uint32_t>
+            static constexpr CW_FORCEINLINE void decrypt_block(V& v0, V& v1) {
                 using C = config<K0, K1, K2, K3>;
                 uint32_t ks = K0 + C::ks_step * C::rounds;
                 for (uint32_t i = 0; i < C::rounds; ++i) {
@@ -2384,7 +3827,7 @@ namespace cloakwork {
                         ks -= C::ks_step;
                         v0 -= ((v1 << C::sh0) ^ (v1 >> C::sh1) ^ (v1 << C::sh2)) ^ (ks * C::mix_0);
                     } else if constexpr (C::variant == 3) {
-                        uint32_t t = v0 ^ (v0 >> C::sh3);
+                        V t = v0 ^ (v0 >> C::sh3);
                         v1 -= ((t << C::sh2) + (t * C::mix_1)) ^ ks;
                         ks -= C::ks_step;
                         t = v1 ^ (v1 >> C::sh1);
@@ -2396,10 +3839,10 @@ namespace cloakwork {
                         v0 -= (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (ks ^ C::mix_0);
                     } else if constexpr (C::variant == 5) {
                         // speck-like inverse: undo xor first, then sub
-                        uint32_t t1 = (v0 << C::sh0) | (v0 >> (32u - C::sh0));
+                        V t1 = (v0 << C::sh0) | (v0 >> (32u - C::sh0));
                         v1 ^= (t1 + v0) ^ ks;
                         ks -= C::ks_step;
-                        uint32_t t0 = (v1 >> C::sh1) | (v1 << (32u - C::sh1));
+                        V t0 = (v1 >> C::sh1) | (v1 << (32u - C::sh1));
                         v0 -= (t0 + v1) ^ ks;
                     } else if constexpr (C::variant == 6) {
                         // quadratic inverse
@@ -2408,7 +3851,7 @@ namespace cloakwork {
                         v0 -= ((v1 * v1) ^ (v1 >> C::sh1) ^ C::mix_0) + ks;
                     } else {
                         // split-merge inverse
-                        uint32_t hi = v0 >> 16, lo = v0 & 0xFFFFu;
+                        V hi = v0 >> 16, lo = v0 & 0xFFFFu;
                         v1 -= ((lo * C::mix_1) ^ (hi << C::sh2) ^ (hi >> C::sh3)) ^ ks;
                         ks -= C::ks_step;
                         hi = v1 >> 16; lo = v1 & 0xFFFFu;
@@ -2417,8 +3860,254 @@ namespace cloakwork {
                 }
             }
 
+            // key stream for the bytes after the last full block
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
+            static constexpr CW_FORCEINLINE uint8_t tail_byte(size_t i) {
+                uint32_t stream = K0 ^ (K1 * static_cast<uint32_t>(i + 1));
+                stream *= K2 | 1u;
+                stream ^= stream >> 16;
+                stream += K3;
+                return static_cast<uint8_t>(stream);
+            }
+
+            // unsigned integer type of a code unit, for the byte/unit conversions below
+            template<size_t Size> struct unit_type;
+            template<> struct unit_type<1> { using type = uint8_t; };
+            template<> struct unit_type<2> { using type = uint16_t; };
+            template<> struct unit_type<4> { using type = uint32_t; };
+
+            template<typename CharT>
+            using unit_t = typename unit_type<sizeof(CharT)>::type;
+
+            //
+            // aes-128-ctr backend (CW_CIPHER_BACKEND=1). the four site keys are the
+            // aes key; counter blocks are (block index, stream) little-endian, so
+            // CW_BLOB chunks each get their own stream. encryption at compile time
+            // is plain software aes; at runtime the keystream comes from aes-ni 8
+            // blocks at a time when cpuid has it, and from the same software aes
+            // otherwise. ctr is self-inverse and has no block tail, but every site
+            // shares one round function instead of a structurally unique feistel.
+            //
+            namespace aes {
+                constexpr uint8_t xtime(uint8_t x) {
+                    return static_cast<uint8_t>((x << 1) ^ ((x & 0x80) ? 0x1B : 0));
+                }
+
+                constexpr uint8_t gf_mul(uint8_t a, uint8_t b) {
+                    uint8_t r = 0;
+                    for (; b; b >>= 1, a = xtime(a))
+                        if (b & 1) r ^= a;
+                    return r;
+                }
+
+                struct sbox_table {
+                    uint8_t v[256];
+
+                    constexpr sbox_table() : v{} {
+                        for (int x = 0; x < 256; ++x) {
+                            // multiplicative inverse as x^254, then the affine map
+                            uint8_t inv = 1, base = static_cast<uint8_t>(x);
+                            for (int e = 254; e; e >>= 1, base = gf_mul(base, base))
+                                if (e & 1) inv = gf_mul(inv, base);
+                            uint8_t s = inv;
+                            for (int r = 1; r < 5; ++r)
+                                s ^= static_cast<uint8_t>((inv << r) | (inv >> (8 - r)));
+                            v[x] = static_cast<uint8_t>(s ^ 0x63);
+                        }
+                    }
+                };
+
+                inline constexpr sbox_table sbox{};
+
+                struct key_schedule {
+                    uint8_t rk[11][16];
+                };
+
+                constexpr key_schedule expand(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3) {
+                    key_schedule ks{};
+                    const uint32_t key[4] = { k0, k1, k2, k3 };
+                    for (int i = 0; i < 16; ++i)
+                        ks.rk[0][i] = static_cast<uint8_t>(key[i / 4] >> (i % 4 * 8));
+                    uint8_t rcon = 1;
+                    for (int r = 1; r < 11; ++r, rcon = xtime(rcon)) {
+                        const uint8_t* prev = ks.rk[r - 1];
+                        uint8_t* cur = ks.rk[r];
+                        cur[0] = prev[0] ^ sbox.v[prev[13]] ^ rcon;
+                        cur[1] = prev[1] ^ sbox.v[prev[14]];
+                        cur[2] = prev[2] ^ sbox.v[prev[15]];
+                        cur[3] = prev[3] ^ sbox.v[prev[12]];
+                        for (int i = 4; i < 16; ++i) cur[i] = prev[i] ^ cur[i - 4];
+                    }
+                    return ks;
+                }
+
+                constexpr void encrypt_block(const key_schedule& ks, uint8_t (&s)[16]) {
+                    for (int i = 0; i < 16; ++i) s[i] ^= ks.rk[0][i];
+                    for (int r = 1; r < 11; ++r) {
+                        uint8_t t[16];
+                        // sub bytes + shift rows: row i of column c comes from column c + i
+                        for (int c = 0; c < 4; ++c)
+                            for (int i = 0; i < 4; ++i)
+                                t[c * 4 + i] = sbox.v[s[(c + i) % 4 * 4 + i]];
+                        if (r < 10) {
+                            for (int c = 0; c < 4; ++c) {
+                                uint8_t* col = t + c * 4;
+                                uint8_t all = col[0] ^ col[1] ^ col[2] ^ col[3], first = col[0];
+                                col[0] ^= all ^ xtime(col[0] ^ col[1]);
+                                col[1] ^= all ^ xtime(col[1] ^ col[2]);
+                                col[2] ^= all ^ xtime(col[2] ^ col[3]);
+                                col[3] ^= all ^ xtime(col[3] ^ first);
+                            }
+                        }
+                        for (int i = 0; i < 16; ++i) s[i] = t[i] ^ ks.rk[r][i];
+                    }
+                }
+
+                constexpr void keystream_block(const key_schedule& ks, uint64_t stream, uint64_t block,
+                                               uint8_t (&out)[16]) {
+                    for (int i = 0; i < 8; ++i) {
+                        out[i] = static_cast<uint8_t>(block >> (i * 8));
+                        out[i + 8] = static_cast<uint8_t>(stream >> (i * 8));
+                    }
+                    encrypt_block(ks, out);
+                }
+
+                // xors keystream byte j into byte j of the code unit sequence,
+                // little-endian within each unit; bytes are just units of one
+                template<typename CharT>
+                constexpr void ctr_soft(CharT* data, size_t len, const key_schedule& ks,
+                                        uint64_t stream, uint64_t first_block) {
+                    using U = unit_t<CharT>;
+                    uint8_t block[16] = {};
+                    uint64_t have = ~uint64_t{0};
+                    for (size_t i = 0; i < len; ++i) {
+                        U unit = static_cast<U>(data[i]);
+                        for (size_t b = 0; b < sizeof(CharT); ++b) {
+                            size_t pos = i * sizeof(CharT) + b;
+                            if (pos / 16 != have) {
+                                have = pos / 16;
+                                keystream_block(ks, stream, first_block + have, block);
+                            }
+                            unit = static_cast<U>(unit ^ (static_cast<U>(block[pos % 16]) << (b * 8)));
+                        }
+                        data[i] = static_cast<CharT>(unit);
+                    }
+                }
+
+#if CW_SIMD
+                template<int Rcon>
+                CW_TARGET("aes,sse2") CW_FORCEINLINE __m128i expand_step(__m128i key) {
+                    __m128i gen = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xFF);
+                    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+                    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+                    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+                    return _mm_xor_si128(key, gen);
+                }
+
+                // one round over eight blocks, spelled out so the lanes stay in registers
+                CW_TARGET("aes,sse2") CW_FORCEINLINE void round8(__m128i (&x)[8], __m128i k) {
+                    x[0] = _mm_aesenc_si128(x[0], k);
+                    x[1] = _mm_aesenc_si128(x[1], k);
+                    x[2] = _mm_aesenc_si128(x[2], k);
+                    x[3] = _mm_aesenc_si128(x[3], k);
+                    x[4] = _mm_aesenc_si128(x[4], k);
+                    x[5] = _mm_aesenc_si128(x[5], k);
+                    x[6] = _mm_aesenc_si128(x[6], k);
+                    x[7] = _mm_aesenc_si128(x[7], k);
+                }
+
+                CW_TARGET("aes,sse2") CW_FORCEINLINE __m128i encrypt_ni(const __m128i (&rk)[11], __m128i x) {
+                    x = _mm_xor_si128(x, rk[0]);
+                    for (int r = 1; r < 10; ++r) x = _mm_aesenc_si128(x, rk[r]);
+                    return _mm_aesenclast_si128(x, rk[10]);
+                }
+
+                // the key schedule is rebuilt per call from the immediates at the call
+                // site instead of sitting expanded in .rodata
+                CW_TARGET("aes,sse2") CW_NOINLINE inline void ctr_ni(uint8_t* data, size_t len,
+                                                                     uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3,
+                                                                     uint64_t stream, uint64_t first_block) {
+                    __m128i rk[11];
+                    rk[0] = _mm_set_epi32(static_cast<int>(k3), static_cast<int>(k2),
+                                          static_cast<int>(k1), static_cast<int>(k0));
+                    rk[1] = expand_step<0x01>(rk[0]);
+                    rk[2] = expand_step<0x02>(rk[1]);
+                    rk[3] = expand_step<0x04>(rk[2]);
+                    rk[4] = expand_step<0x08>(rk[3]);
+                    rk[5] = expand_step<0x10>(rk[4]);
+                    rk[6] = expand_step<0x20>(rk[5]);
+                    rk[7] = expand_step<0x40>(rk[6]);
+                    rk[8] = expand_step<0x80>(rk[7]);
+                    rk[9] = expand_step<0x1B>(rk[8]);
+                    rk[10] = expand_step<0x36>(rk[9]);
+
+                    const long long hi = static_cast<long long>(stream);
+                    uint64_t block = first_block;
+                    size_t i = 0;
+
+                    // eight independent blocks keep the aes unit's pipeline full
+                    for (; i + 128 <= len; i += 128, block += 8) {
+                        __m128i x[8];
+                        for (int j = 0; j < 8; ++j)
+                            x[j] = _mm_xor_si128(_mm_set_epi64x(hi, static_cast<long long>(block + j)), rk[0]);
+                        for (int r = 1; r < 10; ++r) round8(x, rk[r]);
+                        for (int j = 0; j < 8; ++j) {
+                            __m128i ks = _mm_aesenclast_si128(x[j], rk[10]);
+                            __m128i* p = reinterpret_cast<__m128i*>(data + i + j * 16);
+                            _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), ks));
+                        }
+                    }
+                    for (; i + 16 <= len; i += 16, ++block) {
+                        __m128i ks = encrypt_ni(rk, _mm_set_epi64x(hi, static_cast<long long>(block)));
+                        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+                        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), ks));
+                    }
+                    if (i < len) {
+                        alignas(16) uint8_t ks[16];
+                        _mm_store_si128(reinterpret_cast<__m128i*>(ks),
+                            encrypt_ni(rk, _mm_set_epi64x(hi, static_cast<long long>(block))));
+                        for (size_t j = 0; i + j < len; ++j) data[i + j] ^= ks[j];
+                    }
+                }
+#endif
+
+                // keystream xor for one site; encrypt and decrypt are the same call
+                template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename CharT>
+                constexpr void apply(CharT* data, size_t len, uint64_t stream = 0, uint64_t first_block = 0) {
+#if CW_SIMD
+                    // x86 is little-endian, so wide units already are the keystream's byte order
+                    if (!std::is_constant_evaluated() && intrin::cpu().aes) {
+                        ctr_ni(reinterpret_cast<uint8_t*>(data), len * sizeof(CharT), K0, K1, K2, K3, stream, first_block);
+                        return;
+                    }
+#endif
+                    ctr_soft(data, len, expand(K0, K1, K2, K3), stream, first_block);
+                }
+
+                // fips-197 appendix c.1
+                consteval bool known_answer() {
+                    uint8_t block[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                          0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+                    const uint8_t want[16] = { 0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+                                               0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A };
+                    encrypt_block(expand(0x03020100, 0x07060504, 0x0B0A0908, 0x0F0E0D0C), block);
+                    for (int i = 0; i < 16; ++i)
+                        if (block[i] != want[i]) return false;
+                    return true;
+                }
+
+                static_assert(known_answer());
+            }
+
+            // stream tells apart buffers encrypted under the same site keys (CW_BLOB
+            // chunks). the feistel blocks don't chain, so only aes-ctr uses it
             template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename ByteT>
-            static constexpr void encrypt_buffer(ByteT* data, size_t len) {
+            static constexpr void encrypt_buffer(ByteT* data, size_t len, uint64_t stream = 0) {
+                if constexpr (CW_CIPHER_BACKEND == 1) {
+                    aes::apply<K0, K1, K2, K3>(data, len, stream);
+                    return;
+                }
+                (void)stream;
                 for (size_t i = 0; i + 7 < len; i += 8) {
                     uint32_t v0 = static_cast<uint32_t>(static_cast<uint8_t>(data[i]))
                         | (static_cast<uint32_t>(static_cast<uint8_t>(data[i+1])) << 8)
@@ -2443,30 +4132,68 @@ namespace cloakwork {
 
                 // tail bytes: position-dependent xor from key params
                 size_t tail = (len / 8) * 8;
-                for (size_t i = tail; i < len; ++i) {
-                    uint32_t stream = K0 ^ (K1 * static_cast<uint32_t>(i + 1));
-                    stream *= K2 | 1u;
-                    stream ^= stream >> 16;
-                    stream += K3;
-                    data[i] = static_cast<ByteT>(static_cast<uint8_t>(data[i]) ^
-                        static_cast<uint8_t>(stream));
+                for (size_t i = tail; i < len; ++i)
+                    data[i] = static_cast<ByteT>(static_cast<uint8_t>(data[i]) ^ tail_byte<K0, K1, K2, K3>(i));
+            }
+
+#if CW_SIMD
+            // multi-block decrypt: blocks are independent, so run 4 (sse2) or
+            // 8 (avx2) of them through the rounds together. returns blocks done.
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
+            static CW_NOINLINE size_t decrypt_blocks_x4(uint8_t* data, size_t blocks) {
+                size_t b = 0;
+                for (; b + 4 <= blocks; b += 4) {
+                    simd::u32x4 v0, v1;
+                    simd::load_blocks(data + b * 8, v0, v1);
+                    decrypt_block<K0, K1, K2, K3>(v0, v1);
+                    simd::store_blocks(data + b * 8, v0, v1);
                 }
+                return b;
             }
 
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
+            static CW_TARGET("avx2") CW_NOINLINE size_t decrypt_blocks_x8(uint8_t* data, size_t blocks) {
+                size_t b = 0;
+                for (; b + 8 <= blocks; b += 8) {
+                    simd::u32x8 v0, v1;
+                    simd::load_blocks(data + b * 8, v0, v1);
+                    decrypt_block<K0, K1, K2, K3>(v0, v1);
+                    simd::store_blocks(data + b * 8, v0, v1);
+                }
+                return b;
+            }
+#endif
+
             template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename ByteT>
-            static constexpr void decrypt_buffer(ByteT* data, size_t len) {
+            static constexpr void decrypt_buffer(ByteT* data, size_t len, uint64_t stream = 0) {
+                if constexpr (CW_CIPHER_BACKEND == 1) {
+                    aes::apply<K0, K1, K2, K3>(data, len, stream);
+                    return;
+                }
+                (void)stream;
                 // tail first (xor stream is self-inverse)
                 size_t tail = (len / 8) * 8;
-                for (size_t i = tail; i < len; ++i) {
-                    uint32_t stream = K0 ^ (K1 * static_cast<uint32_t>(i + 1));
-                    stream *= K2 | 1u;
-                    stream ^= stream >> 16;
-                    stream += K3;
-                    data[i] = static_cast<ByteT>(static_cast<uint8_t>(data[i]) ^
-                        static_cast<uint8_t>(stream));
+                for (size_t i = tail; i < len; ++i)
+                    data[i] = static_cast<ByteT>(static_cast<uint8_t>(data[i]) ^ tail_byte<K0, K1, K2, K3>(i));
+
+                // wide path for runtime byte buffers; whatever it leaves over
+                // (and everything at compile time) goes through the scalar loop
+                size_t first = 0;
+#if CW_SIMD
+                if constexpr (sizeof(ByteT) == 1) {
+                    if (!std::is_constant_evaluated()) {
+                        uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+                        size_t blocks = len / 8, done = 0;
+                        if (blocks >= 8 && intrin::cpu().avx2)
+                            done = decrypt_blocks_x8<K0, K1, K2, K3>(bytes, blocks);
+                        if (blocks - done >= 4)
+                            done += decrypt_blocks_x4<K0, K1, K2, K3>(bytes + done * 8, blocks - done);
+                        first = done * 8;
+                    }
                 }
+#endif
 
-                for (size_t i = 0; i + 7 < len; i += 8) {
+                for (size_t i = first; i + 7 < len; i += 8) {
                     uint32_t v0 = static_cast<uint32_t>(static_cast<uint8_t>(data[i]))
                         | (static_cast<uint32_t>(static_cast<uint8_t>(data[i+1])) << 8)
                         | (static_cast<uint32_t>(static_cast<uint8_t>(data[i+2])) << 16)
@@ -2476,86 +4203,531 @@ namespace cloakwork {
                         | (static_cast<uint32_t>(static_cast<uint8_t>(data[i+6])) << 16)
                         | (static_cast<uint32_t>(static_cast<uint8_t>(data[i+7])) << 24);
 
-                    decrypt_block<K0, K1, K2, K3>(v0, v1);
+                    decrypt_block<K0, K1, K2, K3>(v0, v1);
+
+                    data[i]   = static_cast<ByteT>(static_cast<uint8_t>(v0));
+                    data[i+1] = static_cast<ByteT>(static_cast<uint8_t>(v0 >> 8));
+                    data[i+2] = static_cast<ByteT>(static_cast<uint8_t>(v0 >> 16));
+                    data[i+3] = static_cast<ByteT>(static_cast<uint8_t>(v0 >> 24));
+                    data[i+4] = static_cast<ByteT>(static_cast<uint8_t>(v1));
+                    data[i+5] = static_cast<ByteT>(static_cast<uint8_t>(v1 >> 8));
+                    data[i+6] = static_cast<ByteT>(static_cast<uint8_t>(v1 >> 16));
+                    data[i+7] = static_cast<ByteT>(static_cast<uint8_t>(v1 >> 24));
+                }
+            }
+
+            //
+            // compares the first len plaintext bytes of a ciphertext (ct_len bytes,
+            // len <= ct_len) with in, decrypting one block at a time into registers.
+            // the early-exit form stops at the first differing block; ConstantTime
+            // decrypts every block and folds the differences together instead.
+            //
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, bool ConstantTime>
+            static CW_FORCEINLINE bool compare_prefix(const char* ct, size_t ct_len, const char* in, size_t len) {
+                const uint8_t* c = reinterpret_cast<const uint8_t*>(ct);
+                const uint8_t* p = reinterpret_cast<const uint8_t*>(in);
+                if constexpr (CW_CIPHER_BACKEND == 1) {
+                    // a few ctr blocks at a time through a wiped stack window
+                    uint8_t window[64];
+                    uint64_t diff = 0;
+                    for (size_t i = 0; i < len; i += sizeof(window)) {
+                        size_t n = len - i < sizeof(window) ? len - i : sizeof(window);
+                        memcpy(window, c + i, n);
+                        aes::apply<K0, K1, K2, K3>(window, n, 0, i / 16);
+                        for (size_t j = 0; j < n; ++j) diff |= static_cast<uint8_t>(window[j] ^ p[i + j]);
+                        if constexpr (!ConstantTime) {
+                            if (diff) break;
+                        }
+                    }
+                    volatile uint8_t* wipe = window;
+                    for (size_t j = 0; j < sizeof(window); ++j) wipe[j] = 0;
+                    (void)ct_len;
+                    return diff == 0;
+                }
+                size_t full = (ct_len / 8) * 8;
+                uint64_t diff = 0;
+                size_t i = 0;
+                for (; i < full && i < len; i += 8) {
+                    uint32_t v0 = c[i] | (static_cast<uint32_t>(c[i+1]) << 8)
+                        | (static_cast<uint32_t>(c[i+2]) << 16) | (static_cast<uint32_t>(c[i+3]) << 24);
+                    uint32_t v1 = c[i+4] | (static_cast<uint32_t>(c[i+5]) << 8)
+                        | (static_cast<uint32_t>(c[i+6]) << 16) | (static_cast<uint32_t>(c[i+7]) << 24);
+                    decrypt_block<K0, K1, K2, K3>(v0, v1);
+
+                    uint64_t got = static_cast<uint64_t>(v1) << 32 | v0;
+                    if (len - i >= 8) {
+                        uint64_t want = 0;
+                        for (size_t j = 0; j < 8; ++j)
+                            want |= static_cast<uint64_t>(p[i + j]) << (j * 8);
+                        diff |= got ^ want;
+                    } else {
+                        // last block holds the terminator; only len - i bytes count
+                        for (size_t j = 0; j < len - i; ++j)
+                            diff |= static_cast<uint8_t>(got >> (j * 8)) ^ p[i + j];
+                    }
+                    if constexpr (!ConstantTime) {
+                        if (diff) return false;
+                    }
+                }
+                for (; i < len; ++i)
+                    diff |= static_cast<uint8_t>(c[i] ^ tail_byte<K0, K1, K2, K3>(i) ^ p[i]);
+                return diff == 0;
+            }
+
+            //
+            // code-unit path for char16_t / char32_t / wchar_t. units are packed
+            // little-endian into the two block words (4 x 16-bit or 2 x 32-bit),
+            // which is exactly their in-memory layout on x86/arm, so at runtime the
+            // blocks go straight through decrypt_buffer. 1-byte units are bytes.
+            //
+            template<typename CharT>
+            static constexpr void load_units(const CharT* p, uint32_t& v0, uint32_t& v1) {
+                using U = unit_t<CharT>;
+                if constexpr (sizeof(CharT) == 2) {
+                    v0 = static_cast<uint32_t>(static_cast<U>(p[0])) | (static_cast<uint32_t>(static_cast<U>(p[1])) << 16);
+                    v1 = static_cast<uint32_t>(static_cast<U>(p[2])) | (static_cast<uint32_t>(static_cast<U>(p[3])) << 16);
+                } else {
+                    v0 = static_cast<uint32_t>(static_cast<U>(p[0]));
+                    v1 = static_cast<uint32_t>(static_cast<U>(p[1]));
+                }
+            }
+
+            template<typename CharT>
+            static constexpr void store_units(CharT* p, uint32_t v0, uint32_t v1) {
+                using U = unit_t<CharT>;
+                if constexpr (sizeof(CharT) == 2) {
+                    p[0] = static_cast<CharT>(static_cast<U>(v0));
+                    p[1] = static_cast<CharT>(static_cast<U>(v0 >> 16));
+                    p[2] = static_cast<CharT>(static_cast<U>(v1));
+                    p[3] = static_cast<CharT>(static_cast<U>(v1 >> 16));
+                } else {
+                    p[0] = static_cast<CharT>(static_cast<U>(v0));
+                    p[1] = static_cast<CharT>(static_cast<U>(v1));
+                }
+            }
+
+            // same position-dependent xor as the byte tail, a whole unit at a time
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename CharT>
+            static constexpr void xor_unit_tail(CharT* data, size_t from, size_t len) {
+                using U = unit_t<CharT>;
+                for (size_t i = from; i < len; ++i) {
+                    uint32_t stream = K0 ^ (K1 * static_cast<uint32_t>(i + 1));
+                    stream *= K2 | 1u;
+                    stream ^= stream >> 16;
+                    stream += K3;
+                    data[i] = static_cast<CharT>(static_cast<U>(static_cast<U>(data[i]) ^ static_cast<U>(stream)));
+                }
+            }
+
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename CharT>
+            static constexpr void encrypt_units(CharT* data, size_t len) {
+                if constexpr (CW_CIPHER_BACKEND == 1) {
+                    aes::apply<K0, K1, K2, K3>(data, len);
+                } else if constexpr (sizeof(CharT) == 1) {
+                    encrypt_buffer<K0, K1, K2, K3>(data, len);
+                } else {
+                    constexpr size_t per_block = 8 / sizeof(CharT);
+                    const size_t full = len / per_block * per_block;
+                    for (size_t i = 0; i < full; i += per_block) {
+                        uint32_t v0 = 0, v1 = 0;
+                        load_units(data + i, v0, v1);
+                        encrypt_block<K0, K1, K2, K3>(v0, v1);
+                        store_units(data + i, v0, v1);
+                    }
+                    xor_unit_tail<K0, K1, K2, K3>(data, full, len);
+                }
+            }
+
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3, typename CharT>
+            static constexpr void decrypt_units(CharT* data, size_t len) {
+                if constexpr (CW_CIPHER_BACKEND == 1) {
+                    aes::apply<K0, K1, K2, K3>(data, len);
+                } else if constexpr (sizeof(CharT) == 1) {
+                    decrypt_buffer<K0, K1, K2, K3>(data, len);
+                } else {
+                    constexpr size_t per_block = 8 / sizeof(CharT);
+                    const size_t full = len / per_block * per_block;
+                    xor_unit_tail<K0, K1, K2, K3>(data, full, len);
+#if CW_SIMD
+                    // x86 is little-endian, so the units already are the block bytes
+                    if (!std::is_constant_evaluated()) {
+                        decrypt_buffer<K0, K1, K2, K3>(reinterpret_cast<uint8_t*>(data), full * sizeof(CharT));
+                        return;
+                    }
+#endif
+                    for (size_t i = 0; i < full; i += per_block) {
+                        uint32_t v0 = 0, v1 = 0;
+                        load_units(data + i, v0, v1);
+                        decrypt_block<K0, K1, K2, K3>(v0, v1);
+                        store_units(data + i, v0, v1);
+                    }
+                }
+            }
+
+            // compile-time proof that encrypt/decrypt are exact inverses
+            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
+            static consteval bool verify_roundtrip() {
+                uint32_t v0 = 0xDEADBEEF, v1 = 0xCAFEBABE;
+                uint32_t orig_v0 = v0, orig_v1 = v1;
+                encrypt_block<K0, K1, K2, K3>(v0, v1);
+                decrypt_block<K0, K1, K2, K3>(v0, v1);
+                return v0 == orig_v0 && v1 == orig_v1;
+            }
+
+            // exercises all 8 round function variants + edge cases
+            static_assert(verify_roundtrip<0x00345678, 0x9ABCDEF0, 0x11111111, 0x22222222>()); // variant 0: arx
+            static_assert(verify_roundtrip<0x01ADBEEF, 0xCAFEBABE, 0xFEEDFACE, 0x01020304>()); // variant 1: multiply-first
+            static_assert(verify_roundtrip<0x02000000, 0x55555555, 0xAAAAAAAA, 0x33333333>()); // variant 2: dual-shift
+            static_assert(verify_roundtrip<0x03C0FFEE, 0x12345678, 0x87654321, 0xDEADCAFE>()); // variant 3: interleaved
+            static_assert(verify_roundtrip<0x04B00B1E, 0xFACEFEED, 0xCAFED00D, 0xBAADF00D>()); // variant 4: xtea-style
+            static_assert(verify_roundtrip<0x05DECADE, 0xC0DEC0DE, 0x8BADF00D, 0xDEFEC8ED>()); // variant 5: speck-like
+            static_assert(verify_roundtrip<0x06F00BAA, 0xABADBABE, 0xBEEFCAFE, 0xFEEDFACE>()); // variant 6: quadratic
+            static_assert(verify_roundtrip<0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF>()); // variant 7: split-merge
+            static_assert(verify_roundtrip<0, 0, 0, 0>());                                     // edge: all zeros, dw about it
+
+            //
+            // lightweight stream cipher for runtime re-keying.
+            // position-dependent xor — self-inverse, so encrypt == decrypt (always ensure encrypt == decrypt please if you're modifying).
+            // used where keys are generated at runtime and can't be template params.
+            //
+            // turns k1 * (i + 1) into the keystream word for position i. V is
+            // uint32_t or a simd lane type, updated in place like decrypt_block
+            template<typename V>
+            static CW_FORCEINLINE void rt_stream(V& v, uint32_t k0, uint32_t k2, uint32_t k3) {
+                v = (v ^ k0) * (k2 | 1u);
+                v ^= v >> 16;
+                v += k3;
+            }
+
+#if CW_SIMD
+            // 32 positions per iteration with avx2's native 32-bit multiply
+            // (sse2 has to emulate it). returns bytes done
+            static CW_TARGET("avx2") CW_NOINLINE size_t rt_encrypt_x8(uint8_t* data, size_t len,
+                                                                     uint32_t k0, uint32_t k1,
+                                                                     uint32_t k2, uint32_t k3) {
+                simd::u32x8 scaled = (simd::lane_index8() + 1u) * k1;
+                const uint32_t step = 8u * k1;
+                size_t i = 0;
+                for (; i + 32 <= len; i += 32) {
+                    simd::u32x8 a = scaled, b = scaled + step, c = scaled + 2u * step, d = scaled + 3u * step;
+                    rt_stream(a, k0, k2, k3);
+                    rt_stream(b, k0, k2, k3);
+                    rt_stream(c, k0, k2, k3);
+                    rt_stream(d, k0, k2, k3);
+                    scaled += 4u * step;
+                    simd::xor_bytes(data + i, simd::low_bytes(a, b, c, d));
+                }
+                return i;
+            }
+#endif
+
+            template<typename ByteT>
+            static CW_FORCEINLINE void rt_encrypt(ByteT* data, size_t len,
+                                                  uint32_t k0, uint32_t k1,
+                                                  uint32_t k2, uint32_t k3) {
+                size_t i = 0;
+#if CW_SIMD
+                // 32 positions at a time under avx2, then 16 as four u32x4, then 4
+                if constexpr (sizeof(ByteT) == 1) {
+                    uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+                    if (len >= 128 && intrin::cpu().avx2)
+                        i = rt_encrypt_x8(bytes, len, k0, k1, k2, k3);
+                    simd::u32x4 scaled = (simd::lane_index() + static_cast<uint32_t>(i + 1)) * k1;
+                    const uint32_t step = 4u * k1;
+                    for (; i + 16 <= len; i += 16) {
+                        simd::u32x4 a = scaled, b = scaled + step, c = scaled + 2u * step, d = scaled + 3u * step;
+                        rt_stream(a, k0, k2, k3);
+                        rt_stream(b, k0, k2, k3);
+                        rt_stream(c, k0, k2, k3);
+                        rt_stream(d, k0, k2, k3);
+                        scaled += 4u * step;
+                        simd::xor_bytes(bytes + i, simd::low_bytes(a, b, c, d));
+                    }
+                    for (; i + 4 <= len; i += 4) {
+                        simd::u32x4 a = scaled;
+                        rt_stream(a, k0, k2, k3);
+                        scaled += step;
+                        simd::xor_bytes(bytes + i, simd::low_bytes(a));
+                    }
+                }
+#endif
+                for (; i < len; ++i) {
+                    uint32_t stream = k1 * static_cast<uint32_t>(i + 1);
+                    rt_stream(stream, k0, k2, k3);
+                    data[i] = static_cast<ByteT>(static_cast<uint8_t>(data[i]) ^
+                        static_cast<uint8_t>(stream));
+                }
+            }
+        }
+
+        //
+        // one 32-bit state word per site instead of a mutex + flag.
+        // the first caller to move encrypted -> decrypting does the work; anyone
+        // racing it spins briefly, then blocks on the word (futex on linux,
+        // WaitOnAddress on windows) until it turns plain.
+        //
+        namespace detail {
+            enum : uint32_t {
+                state_encrypted  = 0,
+                state_decrypting = 1,
+                state_plain      = 2,
+            };
+
+            // returns true for the one caller that actually ran fn
+            template<typename Fn>
+            CW_NOINLINE bool decrypt_once(CW_ATOMIC(uint32_t)& state, Fn&& fn) {
+                for (;;) {
+                    uint32_t cur = state_encrypted;
+                    if (state.compare_exchange_strong(cur, state_decrypting,
+                                                      CW_MO_ACQUIRE, CW_MO_ACQUIRE)) {
+                        fn();
+                        state.store(state_plain, CW_MO_RELEASE);
+                        state.notify_all();
+                        return true;
+                    }
+                    if (cur == state_plain) return false;
+
+                    for (int spin = 0; spin < 64; ++spin) {
+                        intrin::cpu_pause();
+                        cur = state.load(CW_MO_ACQUIRE);
+                        if (cur != state_decrypting) break;
+                    }
+                    while (cur == state_decrypting) {
+                        state.wait(state_decrypting, CW_MO_ACQUIRE);
+                        cur = state.load(CW_MO_ACQUIRE);
+                    }
+                    if (cur == state_plain) return false;
+                    // went back to encrypted (static teardown re-encrypted it), retry
+                }
+            }
+
+            // plain -> encrypted, used on teardown. no-op if never decrypted
+            template<typename Fn>
+            CW_FORCEINLINE void encrypt_once(CW_ATOMIC(uint32_t)& state, Fn&& fn) {
+                uint32_t cur = state_plain;
+                if (state.compare_exchange_strong(cur, state_decrypting,
+                                                  CW_MO_ACQUIRE, CW_MO_RELAXED)) {
+                    fn();
+                    state.store(state_encrypted, CW_MO_RELEASE);
+                    state.notify_all();
+                }
+            }
+
+#if CW_TRIVIAL_STRINGS
+            //
+            // trivially destructible mode: string objects carry no destructor (so
+            // no atexit registration or guard on first use). instead the thread
+            // that decrypts a site pushes the site's intrusive node onto one
+            // lock-free list, and wipe_all() re-encrypts whatever is on it.
+            //
+            struct wipe_node {
+                wipe_node* next;
+                const void* self;
+                void (*wipe)(const void*);
+            };
+
+            inline std::atomic<wipe_node*> wipe_head{nullptr};
+
+            inline void track_decrypted(wipe_node* node) {
+                wipe_node* head = wipe_head.load(std::memory_order_relaxed);
+                do {
+                    node->next = head;
+                } while (!wipe_head.compare_exchange_weak(head, node,
+                             std::memory_order_release, std::memory_order_relaxed));
+            }
+#endif
+
+            //
+            // plaintext arena for encrypted_string. the ciphertext stays in rodata
+            // (shared, clean pages across forked workers) and decrypted copies are
+            // packed into a few heap chunks, so only strings that are actually used
+            // cost private memory. a site keeps its slot for life and reuses it
+            // after a wipe; chunks are never freed, and neither is the arena, so a
+            // site wiped from a static destructor never finds the lock destroyed.
+            //
+            struct plain_arena {
+                CW_MUTEX lock;
+                char* cur = nullptr;
+                size_t left = 0;
+
+                char* alloc(size_t len) {
+                    len = (len + 7) & ~static_cast<size_t>(7);
+                    if (len > CW_STR_ARENA_CHUNK / 4) return new char[len];
+                    CW_LOCK_GUARD(lock);
+                    if (len > left) {
+                        cur = new char[CW_STR_ARENA_CHUNK];
+                        left = CW_STR_ARENA_CHUNK;
+                    }
+                    char* p = cur;
+                    cur += len;
+                    left -= len;
+                    return p;
+                }
+            };
+
+            inline plain_arena& arena() {
+                static plain_arena& a = *new plain_arena;
+                return a;
+            }
+        }
+
+        //
+        // every CW_STR / CW_WSTR site registers a decrypt thunk, so the whole
+        // program's strings can be enumerated. the thunk calls back into the
+        // site itself, so the site's static is initialized (and its destructor
+        // registered) exactly as on a normal first call.
+        //
+        // msvc and clang put the entries in their own linker section, which
+        // costs no initializer at all: msvc sorts cwstr$a < $m < $z and may pad
+        // between contributions (hence the null check); elf gives us
+        // __start_/__stop_ for any section named like an identifier. gcc
+        // silently drops section attributes on anything inside a template, so
+        // there each site links a node onto a list from a static initializer.
+        //
+        struct registry_entry {
+            void (*decrypt)();
+        };
+
+        namespace detail {
+            // Site is the local struct a CW_STR expansion declares around its static
+            template<typename Site>
+            void site_decrypt() { (void)Site::get(); }
+        }
+
+#if defined(_MSC_VER)
+    #pragma section("cwstr$a", read, write)
+    #pragma section("cwstr$m", read, write)
+    #pragma section("cwstr$z", read, write)
+    #define CW_STR_REGISTRY 1
+    #define CW_STR_REGISTRY_ENTRY __declspec(allocate("cwstr$m"))
+    // msvc drops unreferenced comdat data under /OPT:REF, so touch the entry once
+    #define CW_STR_REGISTRY_KEEP(e) \
+        (void)*static_cast<void (* const volatile*)()>(&(e).decrypt)
+
+        namespace detail {
+            __declspec(allocate("cwstr$a")) inline registry_entry registry_begin{};
+            __declspec(allocate("cwstr$z")) inline registry_entry registry_end{};
 
-                    data[i]   = static_cast<ByteT>(static_cast<uint8_t>(v0));
-                    data[i+1] = static_cast<ByteT>(static_cast<uint8_t>(v0 >> 8));
-                    data[i+2] = static_cast<ByteT>(static_cast<uint8_t>(v0 >> 16));
-                    data[i+3] = static_cast<ByteT>(static_cast<uint8_t>(v0 >> 24));
-                    data[i+4] = static_cast<ByteT>(static_cast<uint8_t>(v1));
-                    data[i+5] = static_cast<ByteT>(static_cast<uint8_t>(v1 >> 8));
-                    data[i+6] = static_cast<ByteT>(static_cast<uint8_t>(v1 >> 16));
-                    data[i+7] = static_cast<ByteT>(static_cast<uint8_t>(v1 >> 24));
-                }
+            inline void collect_sites(std::vector<void (*)()>& out) {
+                for (registry_entry* e = &registry_begin + 1; e < &registry_end; ++e)
+                    if (e->decrypt) out.push_back(e->decrypt);
             }
+        }
+#elif defined(__GNUC__) && !defined(__clang__)
+    #define CW_STR_REGISTRY 2
 
-            // compile-time proof that encrypt/decrypt are exact inverses
-            template<uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
-            static consteval bool verify_roundtrip() {
-                uint32_t v0 = 0xDEADBEEF, v1 = 0xCAFEBABE;
-                uint32_t orig_v0 = v0, orig_v1 = v1;
-                encrypt_block<K0, K1, K2, K3>(v0, v1);
-                decrypt_block<K0, K1, K2, K3>(v0, v1);
-                return v0 == orig_v0 && v1 == orig_v1;
+        namespace detail {
+            struct registry_node {
+                registry_entry entry;
+                registry_node* next;
+            };
+
+            inline constinit std::atomic<registry_node*> registry_head{nullptr};
+
+            inline bool link_site(registry_node* node) {
+                registry_node* head = registry_head.load(std::memory_order_relaxed);
+                do {
+                    node->next = head;
+                } while (!registry_head.compare_exchange_weak(head, node,
+                             std::memory_order_release, std::memory_order_relaxed));
+                return true;
             }
 
-            // exercises all 8 round function variants + edge cases
-            static_assert(verify_roundtrip<0x00345678, 0x9ABCDEF0, 0x11111111, 0x22222222>()); // variant 0: arx
-            static_assert(verify_roundtrip<0x01ADBEEF, 0xCAFEBABE, 0xFEEDFACE, 0x01020304>()); // variant 1: multiply-first
-            static_assert(verify_roundtrip<0x02000000, 0x55555555, 0xAAAAAAAA, 0x33333333>()); // variant 2: dual-shift
-            static_assert(verify_roundtrip<0x03C0FFEE, 0x12345678, 0x87654321, 0xDEADCAFE>()); // variant 3: interleaved
-            static_assert(verify_roundtrip<0x04B00B1E, 0xFACEFEED, 0xCAFED00D, 0xBAADF00D>()); // variant 4: xtea-style
-            static_assert(verify_roundtrip<0x05DECADE, 0xC0DEC0DE, 0x8BADF00D, 0xDEFEC8ED>()); // variant 5: speck-like
-            static_assert(verify_roundtrip<0x06F00BAA, 0xABADBABE, 0xBEEFCAFE, 0xFEEDFACE>()); // variant 6: quadratic
-            static_assert(verify_roundtrip<0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF>()); // variant 7: split-merge
-            static_assert(verify_roundtrip<0, 0, 0, 0>());                                     // edge: all zeros, dw about it
+            // one instantiation per site; naming `linked` is what pulls in its initializer
+            template<typename Site>
+            struct registry_link {
+                static inline constinit registry_node node{{&site_decrypt<Site>}, nullptr};
+                static inline const bool linked = link_site(&node);
+            };
 
-            //
-            // lightweight stream cipher for runtime re-keying.
-            // position-dependent xor — self-inverse, so encrypt == decrypt (always ensure encrypt == decrypt please if you're modifying).
-            // used where keys are generated at runtime and can't be template params.
-            //
-            template<typename ByteT>
-            static CW_FORCEINLINE void rt_encrypt(ByteT* data, size_t len,
-                                                  uint32_t k0, uint32_t k1,
-                                                  uint32_t k2, uint32_t k3) {
-                for (size_t i = 0; i < len; ++i) {
-                    uint32_t stream = k0 ^ (k1 * static_cast<uint32_t>(i + 1));
-                    stream *= k2 | 1u;
-                    stream ^= stream >> 16;
-                    stream += k3;
-                    data[i] = static_cast<ByteT>(static_cast<uint8_t>(data[i]) ^
-                        static_cast<uint8_t>(stream));
-                }
+            inline void collect_sites(std::vector<void (*)()>& out) {
+                for (registry_node* n = registry_head.load(std::memory_order_acquire); n; n = n->next)
+                    out.push_back(n->entry.decrypt);
+            }
+        }
+#elif defined(__ELF__)
+    #define CW_STR_REGISTRY 1
+    #define CW_STR_REGISTRY_ENTRY __attribute__((used, section("cw_strings")))
+    #define CW_STR_REGISTRY_KEEP(e) ((void)0)
+
+        namespace detail {
+            // linker-provided bounds; weak so a program without a single CW_STR still links
+            extern registry_entry registry_start[] __asm__("__start_cw_strings")
+                __attribute__((weak, visibility("hidden")));
+            extern registry_entry registry_stop[] __asm__("__stop_cw_strings")
+                __attribute__((weak, visibility("hidden")));
+
+            inline void collect_sites(std::vector<void (*)()>& out) {
+                if (!registry_start) return;
+                for (registry_entry* e = registry_start; e < registry_stop; ++e)
+                    if (e->decrypt) out.push_back(e->decrypt);
             }
         }
+#else
+    #define CW_STR_REGISTRY 0
+        namespace detail {
+            inline void collect_sites(std::vector<void (*)()>&) {}
+        }
+#endif
+
+        //
+        // decrypts every registered string up front so first calls on the hot
+        // path only see the plain state. threads == 0 uses one per hardware
+        // thread; the calling thread always takes part. sites race normally
+        // with concurrent get() calls, so this is safe to run while serving.
+        // returns the number of sites touched.
+        //
+        inline size_t predecrypt_all(unsigned threads = 0) {
+            std::vector<void (*)()> sites;
+            detail::collect_sites(sites);
+            const size_t count = sites.size();
+            if (count == 0) return 0;
+
+            constexpr size_t batch = 16;
+            if (threads == 0) threads = std::thread::hardware_concurrency();
+            size_t workers = (count + batch - 1) / batch;
+            if (threads < workers) workers = threads ? threads : 1;
+
+            CW_ATOMIC(size_t) next{0};
+            auto worker = [&] {
+                for (;;) {
+                    size_t begin = next.fetch_add(batch, CW_MO_RELAXED);
+                    if (begin >= count) break;
+                    size_t end = begin + batch < count ? begin + batch : count;
+                    for (size_t i = begin; i < end; ++i)
+                        sites[i]();
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(workers - 1);
+            for (size_t t = 1; t < workers; ++t)
+                pool.emplace_back(worker);
+            worker();
+            for (auto& t : pool) t.join();
+            return count;
+        }
+
+        template<size_t N, uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
+        struct encrypted_literal;
 
         template<size_t N,
                  uint32_t K0 = CW_RANDOM_CT(), uint32_t K1 = CW_RANDOM_CT(),
                  uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT()>
         class encrypted_string {
         private:
-            std::array<char, N> data;
-            mutable CW_ATOMIC(bool) decrypted{false};
-            mutable CW_MUTEX mutex;
-
-
-
-            // no reinterpret_cast - uses templated buffer functions for constexpr compatibility
-            static constexpr std::array<char, N> encrypt_string(const char* str) {
-                std::array<char, N> result{};
-                for (size_t i = 0; i < N; ++i) result[i] = str[i];
-                cipher::encrypt_buffer<K0, K1, K2, K3>(result.data(), N);
-                return result;
-            }
+            // ciphertext lives in the (read-only) literal; this object only holds
+            // the state word and, once used, its slot in the plaintext arena
+            const encrypted_literal<N, K0, K1, K2, K3>* lit;
+            mutable char* plain{nullptr};
+            mutable CW_ATOMIC(uint32_t) state{detail::state_encrypted};
+#if CW_TRIVIAL_STRINGS
+            mutable detail::wipe_node wipe_link{nullptr, this, &wipe_thunk};
+#endif
 
         public:
-            template<size_t... I>
-            constexpr encrypted_string(const char (&str)[N], std::index_sequence<I...>)
-                : data(encrypt_string(str)), decrypted(false) {}
-
-            constexpr encrypted_string(const char (&str)[N])
-                : encrypted_string(str, std::make_index_sequence<N>{}) {}
+            constexpr encrypted_string(const encrypted_literal<N, K0, K1, K2, K3>& l)
+                : lit(&l) {}
 
             //
             // noinline prevents LTCG from constant-folding the decrypt.
@@ -2599,27 +4771,30 @@ namespace cloakwork {
                     _pa[2] = _pa[0] * (_pa[1] | 1u);
                     (void)_pa[3];
                 }
-                if (!decrypted.load(CW_MO_ACQUIRE)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (!decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<char, N>&>(data);
+                if (state.load(CW_MO_ACQUIRE) != detail::state_plain) {
+                    auto decrypt = [this] {
+                        if (!plain) plain = detail::arena().alloc(N);
+                        char* mutable_data = plain;
+                        const char* src = lit->bytes.data();
+                        CW_LAUNDER(src);
+                        memcpy(mutable_data, src, N);
 #if CW_ENABLE_CONTROL_FLOW
                         if constexpr ((K1 & 3u) == 0) {
                             if (control_flow::opaque_true<static_cast<int>(K1 & 0x7F)>()) {
-                                cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
                             } else {
                                 for (size_t _fi = 0; _fi < N; ++_fi)
                                     mutable_data[_fi] ^= static_cast<char>(K2 >> ((_fi & 3u) * 8u));
                             }
                         } else if constexpr ((K1 & 3u) == 1) {
-                            cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                            cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
                             if (control_flow::opaque_false<static_cast<int>(K1 & 0x7F)>()) {
-                                cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
                             }
                         } else if constexpr ((K1 & 3u) == 2) {
                             if (control_flow::opaque_true<static_cast<int>(K1 & 0x7F)>()) {
                                 if (control_flow::opaque_true<static_cast<int>((K1 >> 7) & 0x7F)>()) {
-                                    cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                    cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
                                 } else {
                                     for (size_t _fi = N; _fi > 0; --_fi)
                                         mutable_data[_fi-1] = static_cast<char>(
@@ -2633,18 +4808,23 @@ namespace cloakwork {
                                 }
                             }
                         } else {
-                            cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                            cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
                             if (control_flow::opaque_false<static_cast<int>(K1 & 0x7F)>()) {
                                 volatile uint8_t _vb = static_cast<uint8_t>(mutable_data[0]);
                                 if (_vb != static_cast<uint8_t>(K3 & 0xFF))
-                                    cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                    cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
                             }
                         }
 #else
-                        cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                        cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data, N);
+#endif
+                    };
+#if CW_TRIVIAL_STRINGS
+                    if (detail::decrypt_once(state, decrypt))
+                        detail::track_decrypted(&wipe_link);
+#else
+                    detail::decrypt_once(state, decrypt);
 #endif
-                        decrypted.store(true, CW_MO_RELEASE);
-                    }
                 }
                 if constexpr ((K2 & 7u) == 0) {
                     volatile uint32_t _e = K3; _e *= 0x119DE1F3u; _e ^= _e >> 16; (void)_e;
@@ -2679,37 +4859,68 @@ namespace cloakwork {
                     _e += _f * (_e | 1u); (void)_e;
                 }
                 CW_COMPILER_BARRIER();
-                return data.data();
+                return plain;
             }
 
             CW_NOINLINE operator const char*() const { return get(); }
 
-            ~encrypted_string() {
-                if (decrypted.load(CW_MO_RELAXED)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<char, N>&>(data);
-                        cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
-                        decrypted.store(false, CW_MO_RELEASE);
-                    }
-                }
+            // zero the arena slot; the destructor, or wipe_all() in trivial mode
+            void wipe_plaintext() const {
+                detail::encrypt_once(state, [this] {
+                    volatile char* p = plain;
+                    for (size_t i = 0; i < N; ++i) p[i] = 0;
+                });
             }
-        };
 
-        template<size_t N>
-        encrypted_string(const char (&)[N]) -> encrypted_string<N>;
+#if CW_TRIVIAL_STRINGS
+            static void wipe_thunk(const void* self) {
+                static_cast<const encrypted_string*>(self)->wipe_plaintext();
+            }
+#else
+            ~encrypted_string() { wipe_plaintext(); }
+#endif
+        };
 
+        //
+        // layered strings keep the at-rest copy (vault) under a key that rotates
+        // at runtime and serve plaintext from two slots, epoch style. a thread
+        // holds the slot it was last handed until its next get() on the string
+        // (or until it exits), counted in readers[]. every Interval reads (per
+        // thread) one thread re-keys the vault, decrypts the idle slot from it,
+        // publishes that slot, and the retired one is wiped as soon as its last
+        // reader moves on. readers never lock; a re-key whose idle slot is still
+        // held is skipped until it drains.
+        //
         template<size_t N,
                  uint32_t K0 = CW_RANDOM_CT(), uint32_t K1 = CW_RANDOM_CT(),
-                 uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT()>
+                 uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT(),
+                 uint32_t Interval = CW_LAYERED_REKEY_INTERVAL>
         class layered_encrypted_string {
         private:
-            std::array<char, N> data;
-            mutable CW_ATOMIC(bool) decrypted{false};
-            mutable CW_ATOMIC(uint32_t) access_count{0};
-            mutable CW_MUTEX mutex;
+            std::array<char, N> vault;
+            mutable std::array<char, N> slots[2]{};
+            mutable CW_ATOMIC(uint32_t) state{detail::state_encrypted};
+#if CW_TRIVIAL_STRINGS
+            mutable detail::wipe_node wipe_link{nullptr, this, &wipe_thunk};
+#endif
+            mutable CW_ATOMIC(uint32_t) active{0};
+            mutable CW_ATOMIC(uint32_t) readers[2]{};
+            mutable CW_ATOMIC(uint32_t) rekeying{0};
+            // runtime keys; written only by the thread holding rekeying
             mutable uint32_t rk0{0}, rk1{0}, rk2{0}, rk3{0};
             mutable bool has_rekeyed{false};
+            // the unpublished slot still holds plaintext. written under rekeying,
+            // read without it by unlock()
+            mutable CW_ATOMIC(uint32_t) retired_plain{0};
+
+            // one per thread and string type: the slot this thread holds and its
+            // re-key countdown. the hold is dropped on the next get() or at thread exit
+            struct reader {
+                const layered_encrypted_string* owner = nullptr;
+                uint32_t slot = 0;
+                uint32_t until_rekey = Interval;
+                ~reader() { if (owner) owner->release(slot); }
+            };
 
             static constexpr std::array<char, N> encrypt_string(const char* str) {
                 std::array<char, N> result{};
@@ -2718,20 +4929,108 @@ namespace cloakwork {
                 return result;
             }
 
-            // re-key: derive new runtime keys from entropy
-            CW_FORCEINLINE void rekey() const {
+            // peel whichever key the vault is under
+            CW_FORCEINLINE void open_vault(char* out) const {
+                memcpy(out, vault.data(), N);
+                if (has_rekeyed)
+                    cipher::rt_encrypt(out, N, rk0, rk1, rk2, rk3);
+                else
+                    cipher::decrypt_buffer<K0, K1, K2, K3>(out, N);
+            }
+
+            static CW_FORCEINLINE void wipe(char* p, size_t len) {
+                volatile char* v = p;
+                for (size_t i = 0; i < len; ++i) v[i] = 0;
+                CW_COMPILER_BARRIER();
+            }
+
+            // caller holds rekeying. zeroes the unpublished slot once nobody holds it
+            void wipe_retired() const {
+                uint32_t idle = active.load(CW_MO_RELAXED) ^ 1u;
+                if (retired_plain.load(CW_MO_RELAXED) && readers[idle].load() == 0) {
+                    wipe(slots[idle].data(), N);
+                    retired_plain.store(0, CW_MO_RELAXED);
+                }
+            }
+
+            // drops rekeying. a release that found it taken left the wipe to the
+            // holder, so look again once it is free: the unlock and the releaser's
+            // count drop and exchange are all seq_cst, so either the releaser got
+            // the lock itself or the count read here already shows the drop
+            void unlock() const {
+                for (;;) {
+                    rekeying.store(0);
+                    if (!retired_plain.load() || readers[active.load() ^ 1u].load() != 0) return;
+                    // someone else holding it now runs this same check
+                    if (rekeying.exchange(1)) return;
+                    wipe_retired();
+                }
+            }
+
+            void release(uint32_t slot) const {
+                // the last reader of a retired slot wipes it, unless a re-key or
+                // wipe is running; that one sees the count drop in unlock()
+                if (readers[slot].fetch_sub(1) == 1 && !rekeying.exchange(1)) {
+                    wipe_retired();
+                    unlock();
+                }
+            }
+
+            // moves this thread's hold to the published slot. the count goes up
+            // before active is checked again, so a re-key either sees the reader or
+            // the reader sees the flip and follows it (both sides are seq_cst)
+            CW_NOINLINE uint32_t hold(reader& me, uint32_t cur) const {
+                for (;;) {
+                    readers[cur].fetch_add(1);
+                    uint32_t now = active.load();
+                    if (now == cur) break;
+                    release(cur);
+                    cur = now;
+                }
+                if (me.owner) me.owner->release(me.slot);
+                me.owner = this;
+                me.slot = cur;
+                return cur;
+            }
+
+            CW_NOINLINE void rekey() const {
+                if (rekeying.exchange(1, CW_MO_ACQUIRE)) return;
+                uint32_t cur = active.load(CW_MO_RELAXED);
+                uint32_t idle = cur ^ 1u;
+                // wiped since this reader decrypted, or a reader from before the
+                // last flip still holds the idle slot: nothing to do this round
+                if (state.load(CW_MO_ACQUIRE) != detail::state_plain || readers[idle].load() != 0) {
+                    unlock();
+                    return;
+                }
+
+                // re-encrypt the at-rest copy under fresh keys, working from the
+                // published plaintext so the vault itself never holds plaintext
                 uint64_t entropy = CW_RANDOM_RT();
-                rk0 = K0 ^ static_cast<uint32_t>(entropy);
-                rk1 = K1 ^ static_cast<uint32_t>(entropy >> 32);
-                rk2 = K2 ^ static_cast<uint32_t>(entropy * (K0 | 1u));
-                rk3 = K3 ^ static_cast<uint32_t>((entropy >> 16) * (K1 | 1u));
+                uint32_t n0 = K0 ^ static_cast<uint32_t>(entropy);
+                uint32_t n1 = K1 ^ static_cast<uint32_t>(entropy >> 32);
+                uint32_t n2 = K2 ^ static_cast<uint32_t>(entropy * (K0 | 1u));
+                uint32_t n3 = K3 ^ static_cast<uint32_t>((entropy >> 16) * (K1 | 1u));
+                char fresh[N];
+                memcpy(fresh, slots[cur].data(), N);
+                cipher::rt_encrypt(fresh, N, n0, n1, n2, n3);
+                memcpy(const_cast<std::array<char, N>&>(vault).data(), fresh, N);
+                rk0 = n0; rk1 = n1; rk2 = n2; rk3 = n3;
                 has_rekeyed = true;
+
+                // the idle slot comes back from the re-keyed vault, then goes live;
+                // the one it replaces is wiped now or by its last reader
+                open_vault(slots[idle].data());
+                active.store(idle);
+                retired_plain.store(1, CW_MO_RELAXED);
+                wipe_retired();
+                unlock();
             }
 
         public:
             template<size_t... I>
             constexpr layered_encrypted_string(const char (&str)[N], std::index_sequence<I...>)
-                : data(encrypt_string(str)), decrypted(false) {}
+                : vault(encrypt_string(str)) {}
 
             constexpr layered_encrypted_string(const char (&str)[N])
                 : layered_encrypted_string(str, std::make_index_sequence<N>{}) {}
@@ -2773,67 +5072,75 @@ namespace cloakwork {
                     _pa[2] = _pa[0] * (_pa[1] | 1u);
                     (void)_pa[3];
                 }
-                if (!decrypted.load(CW_MO_ACQUIRE)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (!decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<char, N>&>(data);
+                if (state.load(CW_MO_ACQUIRE) != detail::state_plain) {
+                    auto decrypt = [this] {
+                        char* plain = slots[active.load(CW_MO_RELAXED)].data();
+                        if (has_rekeyed) {
+                            open_vault(plain);
+                            return;
+                        }
+                        memcpy(plain, vault.data(), N);
 #if CW_ENABLE_CONTROL_FLOW
                         if constexpr ((K1 & 3u) == 0) {
                             if (control_flow::opaque_true<static_cast<int>(K1 & 0x7F)>()) {
-                                cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                cipher::decrypt_buffer<K0, K1, K2, K3>(plain, N);
                             } else {
                                 for (size_t _fi = 0; _fi < N; ++_fi)
-                                    mutable_data[_fi] ^= static_cast<char>(K2 >> ((_fi & 3u) * 8u));
+                                    plain[_fi] ^= static_cast<char>(K2 >> ((_fi & 3u) * 8u));
                             }
                         } else if constexpr ((K1 & 3u) == 1) {
-                            cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                            cipher::decrypt_buffer<K0, K1, K2, K3>(plain, N);
                             if (control_flow::opaque_false<static_cast<int>(K1 & 0x7F)>()) {
-                                cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                cipher::encrypt_buffer<K0, K1, K2, K3>(plain, N);
                             }
                         } else if constexpr ((K1 & 3u) == 2) {
                             if (control_flow::opaque_true<static_cast<int>(K1 & 0x7F)>()) {
                                 if (control_flow::opaque_true<static_cast<int>((K1 >> 7) & 0x7F)>()) {
-                                    cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                    cipher::decrypt_buffer<K0, K1, K2, K3>(plain, N);
                                 } else {
                                     for (size_t _fi = N; _fi > 0; --_fi)
-                                        mutable_data[_fi-1] = static_cast<char>(
-                                            static_cast<uint8_t>(mutable_data[_fi-1]) ^ static_cast<uint8_t>(K3 >> ((_fi & 3u) * 8u)));
+                                        plain[_fi-1] = static_cast<char>(
+                                            static_cast<uint8_t>(plain[_fi-1]) ^ static_cast<uint8_t>(K3 >> ((_fi & 3u) * 8u)));
                                 }
                             } else {
                                 volatile uint32_t _jk = K0;
                                 for (size_t _fi = 0; _fi < N; ++_fi) {
-                                    mutable_data[_fi] ^= static_cast<char>(_jk >> 24);
+                                    plain[_fi] ^= static_cast<char>(_jk >> 24);
                                     _jk = (_jk << 1) | (_jk >> 31);
                                 }
                             }
                         } else {
-                            cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                            cipher::decrypt_buffer<K0, K1, K2, K3>(plain, N);
                             if (control_flow::opaque_false<static_cast<int>(K1 & 0x7F)>()) {
-                                volatile uint8_t _vb = static_cast<uint8_t>(mutable_data[0]);
+                                volatile uint8_t _vb = static_cast<uint8_t>(plain[0]);
                                 if (_vb != static_cast<uint8_t>(K3 & 0xFF))
-                                    cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                                    cipher::encrypt_buffer<K0, K1, K2, K3>(plain, N);
                             }
                         }
 #else
-                        cipher::decrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                        cipher::decrypt_buffer<K0, K1, K2, K3>(plain, N);
+#endif
+                    };
+#if CW_TRIVIAL_STRINGS
+                    if (detail::decrypt_once(state, decrypt))
+                        detail::track_decrypted(&wipe_link);
+#else
+                    detail::decrypt_once(state, decrypt);
 #endif
-                        decrypted.store(true, CW_MO_RELEASE);
-                    }
                 }
 
-                // polymorphic re-encryption every 10 accesses
-                uint32_t count = access_count.fetch_add(1, CW_MO_RELAXED);
-                if (count > 0 && (count % 10) == 0 && decrypted.load(CW_MO_ACQUIRE)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<char, N>&>(data);
-                        if (has_rekeyed)
-                            cipher::rt_encrypt(mutable_data.data(), N, rk0, rk1, rk2, rk3);
-                        else
-                            cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
+                // polymorphic re-encryption, counted per thread so readers don't
+                // share a cache line just to decide when to re-key. with no
+                // re-keying the first slot is the only one ever published
+                uint32_t cur = 0;
+                if constexpr (Interval != 0) {
+                    static thread_local reader me;
+                    if (--me.until_rekey == 0) {
+                        me.until_rekey = Interval;
                         rekey();
-                        cipher::rt_encrypt(mutable_data.data(), N, rk0, rk1, rk2, rk3);
                     }
+                    cur = active.load(CW_MO_ACQUIRE);
+                    if (me.owner != this || me.slot != cur) cur = hold(me, cur);
                 }
 
                 if constexpr ((K2 & 7u) == 0) {
@@ -2869,35 +5176,91 @@ namespace cloakwork {
                     _e += _f * (_e | 1u); (void)_e;
                 }
                 CW_COMPILER_BARRIER();
-                return data.data();
+                return slots[cur].data();
             }
 
             CW_NOINLINE operator const char*() const { return get(); }
 
-            ~layered_encrypted_string() {
-                if (decrypted.load(CW_MO_RELAXED)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<char, N>&>(data);
-                        if (has_rekeyed)
-                            cipher::rt_encrypt(mutable_data.data(), N, rk0, rk1, rk2, rk3);
-                        else
-                            cipher::encrypt_buffer<K0, K1, K2, K3>(mutable_data.data(), N);
-                        decrypted.store(false, CW_MO_RELEASE);
-                    }
-                }
+            // plain -> ciphertext again; the destructor, or wipe_all() in trivial mode
+            void wipe_plaintext() const {
+                // holding the re-key lock keeps an in-flight rekey off the slots
+                while (rekeying.exchange(1, CW_MO_ACQUIRE)) intrin::cpu_pause();
+                detail::encrypt_once(state, [this] {
+                    wipe(slots[0].data(), N);
+                    wipe(slots[1].data(), N);
+                    retired_plain.store(0, CW_MO_RELAXED);
+                });
+                unlock();
+            }
+
+#if CW_TRIVIAL_STRINGS
+            static void wipe_thunk(const void* self) {
+                static_cast<const layered_encrypted_string*>(self)->wipe_plaintext();
             }
+#else
+            ~layered_encrypted_string() { wipe_plaintext(); }
+#endif
         };
 
         template<size_t N>
         layered_encrypted_string(const char (&)[N]) -> layered_encrypted_string<N>;
 
+        //
+        // ciphertext only, no state. lives in rodata as a static constexpr and is
+        // decrypted straight into storage the caller owns, so short-lived copies
+        // never touch a shared object, a state word, or a second buffer.
+        //
+        template<size_t N,
+                 uint32_t K0 = CW_RANDOM_CT(), uint32_t K1 = CW_RANDOM_CT(),
+                 uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT()>
+        struct encrypted_literal {
+            using string_type = encrypted_string<N, K0, K1, K2, K3>;
+
+            std::array<char, N> bytes{};
+
+            consteval encrypted_literal(const char (&str)[N]) {
+                for (size_t i = 0; i < N; ++i) bytes[i] = str[i];
+                cipher::encrypt_buffer<K0, K1, K2, K3>(bytes.data(), N);
+            }
+
+            // out must hold N chars
+            CW_FORCEINLINE void decrypt_into(char* out) const {
+                // the object is constexpr; launder so the decrypt isn't folded to plaintext
+                const char* src = bytes.data();
+                CW_LAUNDER(src);
+                memcpy(out, src, N);
+                cipher::decrypt_buffer<K0, K1, K2, K3>(out, N);
+            }
+
+            // comparisons against the ciphertext; the plaintext never leaves registers.
+            // a length mismatch returns before any block is decrypted
+            template<bool ConstantTime = false>
+            CW_FORCEINLINE bool equals(std::string_view in) const {
+                if (in.size() != N - 1) return false;
+                const char* src = bytes.data();
+                CW_LAUNDER(src);
+                return cipher::compare_prefix<K0, K1, K2, K3, ConstantTime>(src, N, in.data(), N - 1);
+            }
+
+            CW_FORCEINLINE bool is_prefix_of(std::string_view in) const {
+                if (in.size() < N - 1) return false;
+                const char* src = bytes.data();
+                CW_LAUNDER(src);
+                return cipher::compare_prefix<K0, K1, K2, K3, false>(src, N, in.data(), N - 1);
+            }
+        };
+
         template<size_t N>
         class stack_encrypted_string {
         private:
             char buffer[N];
 
         public:
+            template<uint32_t A, uint32_t B, uint32_t C, uint32_t D>
+            stack_encrypted_string(const encrypted_literal<N, A, B, C, D>& lit) {
+                lit.decrypt_into(buffer);
+            }
+
             template<size_t M, uint32_t A, uint32_t B, uint32_t C, uint32_t D>
             stack_encrypted_string(const encrypted_string<M, A, B, C, D>& enc) {
                 const char* decrypted = enc.get();
@@ -2907,6 +5270,7 @@ namespace cloakwork {
 
             const char* get() const { return buffer; }
             operator const char*() const { return buffer; }
+            std::string_view view() const { return std::string_view(buffer, N - 1); }
 
             ~stack_encrypted_string() {
                 // secure wipe: volatile to prevent optimizer removal
@@ -2917,43 +5281,47 @@ namespace cloakwork {
             }
         };
 
-        template<size_t N,
+        // decrypts lit onto the stack, hands fn a view of it, and wipes the copy
+        // when fn returns (or throws). the view must not escape fn.
+        template<size_t N, uint32_t A, uint32_t B, uint32_t C, uint32_t D, typename Fn>
+        CW_FORCEINLINE decltype(auto) with_decrypted(const encrypted_literal<N, A, B, C, D>& lit, Fn&& fn) {
+            stack_encrypted_string<N> plain(lit);
+            return fn(std::string_view(plain.get(), N - 1));
+        }
+
+        //
+        // encrypted literal over any character type. wide / utf-16 / utf-32 units
+        // go through the code-unit cipher directly, so there is no byte staging
+        // buffer and it is correct whatever sizeof(wchar_t) is.
+        //
+        template<typename CharT, size_t N,
                  uint32_t K0 = CW_RANDOM_CT(), uint32_t K1 = CW_RANDOM_CT(),
                  uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT()>
-        class encrypted_wstring {
+        class basic_encrypted_string {
         private:
-            static constexpr size_t BYTE_LEN = N * sizeof(wchar_t);
-            std::array<wchar_t, N> data;
-            mutable CW_ATOMIC(bool) decrypted{false};
-            mutable CW_MUTEX mutex;
-
-
+            using unit_t = cipher::unit_t<CharT>;
+            std::array<CharT, N> data;
+            mutable CW_ATOMIC(uint32_t) state{detail::state_encrypted};
+#if CW_TRIVIAL_STRINGS
+            mutable detail::wipe_node wipe_link{nullptr, this, &wipe_thunk};
+#endif
 
-            // constexpr-safe wchar_t encryption: serialize to bytes, encrypt, deserialize
-            static constexpr std::array<wchar_t, N> encrypt_wstring(const wchar_t* str) {
-                std::array<uint8_t, BYTE_LEN> bytes{};
-                for (size_t i = 0; i < N; ++i) {
-                    bytes[i * 2]     = static_cast<uint8_t>(str[i] & 0xFF);
-                    bytes[i * 2 + 1] = static_cast<uint8_t>((str[i] >> 8) & 0xFF);
-                }
-                cipher::encrypt_buffer<K0, K1, K2, K3>(bytes.data(), BYTE_LEN);
-                std::array<wchar_t, N> result{};
-                for (size_t i = 0; i < N; ++i) {
-                    result[i] = static_cast<wchar_t>(bytes[i * 2])
-                              | (static_cast<wchar_t>(bytes[i * 2 + 1]) << 8);
-                }
+            static constexpr std::array<CharT, N> encrypt_literal(const CharT* str) {
+                std::array<CharT, N> result{};
+                for (size_t i = 0; i < N; ++i) result[i] = str[i];
+                cipher::encrypt_units<K0, K1, K2, K3>(result.data(), N);
                 return result;
             }
 
         public:
             template<size_t... I>
-            constexpr encrypted_wstring(const wchar_t (&str)[N], std::index_sequence<I...>)
-                : data(encrypt_wstring(str)), decrypted(false) {}
+            constexpr basic_encrypted_string(const CharT (&str)[N], std::index_sequence<I...>)
+                : data(encrypt_literal(str)) {}
 
-            constexpr encrypted_wstring(const wchar_t (&str)[N])
-                : encrypted_wstring(str, std::make_index_sequence<N>{}) {}
+            constexpr basic_encrypted_string(const CharT (&str)[N])
+                : basic_encrypted_string(str, std::make_index_sequence<N>{}) {}
 
-            CW_NOINLINE const wchar_t* get() const {
+            CW_NOINLINE const CharT* get() const {
                 CW_COMPILER_BARRIER();
                 if constexpr ((K0 & 7u) == 0) {
                     volatile uint32_t _p = K1; _p ^= _p >> 16; (void)_p;
@@ -2990,60 +5358,55 @@ namespace cloakwork {
                     _pa[2] = _pa[0] * (_pa[1] | 1u);
                     (void)_pa[3];
                 }
-                if (!decrypted.load(CW_MO_ACQUIRE)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (!decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<wchar_t, N>&>(data);
-                        uint8_t bytes[BYTE_LEN];
-                        for (size_t i = 0; i < N; ++i) {
-                            bytes[i * 2]     = static_cast<uint8_t>(mutable_data[i] & 0xFF);
-                            bytes[i * 2 + 1] = static_cast<uint8_t>((mutable_data[i] >> 8) & 0xFF);
-                        }
+                if (state.load(CW_MO_ACQUIRE) != detail::state_plain) {
+                    auto decrypt = [this] {
+                        CharT* units = const_cast<std::array<CharT, N>&>(data).data();
 #if CW_ENABLE_CONTROL_FLOW
                         if constexpr ((K1 & 3u) == 0) {
                             if (control_flow::opaque_true<static_cast<int>(K1 & 0x7F)>()) {
-                                cipher::decrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                                cipher::decrypt_units<K0, K1, K2, K3>(units, N);
                             } else {
-                                for (size_t _fi = 0; _fi < BYTE_LEN; ++_fi)
-                                    bytes[_fi] ^= static_cast<uint8_t>(K2 >> ((_fi & 3u) * 8u));
+                                for (size_t _fi = 0; _fi < N; ++_fi)
+                                    units[_fi] = static_cast<CharT>(static_cast<unit_t>(units[_fi]) ^ static_cast<unit_t>(K2 >> ((_fi & 3u) * 8u)));
                             }
                         } else if constexpr ((K1 & 3u) == 1) {
-                            cipher::decrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                            cipher::decrypt_units<K0, K1, K2, K3>(units, N);
                             if (control_flow::opaque_false<static_cast<int>(K1 & 0x7F)>()) {
-                                cipher::encrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                                cipher::encrypt_units<K0, K1, K2, K3>(units, N);
                             }
                         } else if constexpr ((K1 & 3u) == 2) {
                             if (control_flow::opaque_true<static_cast<int>(K1 & 0x7F)>()) {
                                 if (control_flow::opaque_true<static_cast<int>((K1 >> 7) & 0x7F)>()) {
-                                    cipher::decrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                                    cipher::decrypt_units<K0, K1, K2, K3>(units, N);
                                 } else {
-                                    for (size_t _fi = BYTE_LEN; _fi > 0; --_fi)
-                                        bytes[_fi-1] ^= static_cast<uint8_t>(K3 >> ((_fi & 3u) * 8u));
+                                    for (size_t _fi = N; _fi > 0; --_fi)
+                                        units[_fi-1] = static_cast<CharT>(static_cast<unit_t>(units[_fi-1]) ^ static_cast<unit_t>(K3 >> ((_fi & 3u) * 8u)));
                                 }
                             } else {
                                 volatile uint32_t _jk = K0;
-                                for (size_t _fi = 0; _fi < BYTE_LEN; ++_fi) {
-                                    bytes[_fi] ^= static_cast<uint8_t>(_jk >> 24);
+                                for (size_t _fi = 0; _fi < N; ++_fi) {
+                                    units[_fi] = static_cast<CharT>(static_cast<unit_t>(units[_fi]) ^ static_cast<unit_t>(_jk >> 24));
                                     _jk = (_jk << 1) | (_jk >> 31);
                                 }
                             }
                         } else {
-                            cipher::decrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                            cipher::decrypt_units<K0, K1, K2, K3>(units, N);
                             if (control_flow::opaque_false<static_cast<int>(K1 & 0x7F)>()) {
-                                volatile uint8_t _vb = bytes[0];
-                                if (_vb != static_cast<uint8_t>(K3 & 0xFF))
-                                    cipher::encrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                                volatile unit_t _vb = static_cast<unit_t>(units[0]);
+                                if (_vb != static_cast<unit_t>(K3 & 0xFF))
+                                    cipher::encrypt_units<K0, K1, K2, K3>(units, N);
                             }
                         }
 #else
-                        cipher::decrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
+                        cipher::decrypt_units<K0, K1, K2, K3>(units, N);
+#endif
+                    };
+#if CW_TRIVIAL_STRINGS
+                    if (detail::decrypt_once(state, decrypt))
+                        detail::track_decrypted(&wipe_link);
+#else
+                    detail::decrypt_once(state, decrypt);
 #endif
-                        for (size_t i = 0; i < N; ++i) {
-                            mutable_data[i] = static_cast<wchar_t>(bytes[i * 2])
-                                            | (static_cast<wchar_t>(bytes[i * 2 + 1]) << 8);
-                        }
-                        decrypted.store(true, CW_MO_RELEASE);
-                    }
                 }
                 if constexpr ((K2 & 7u) == 0) {
                     volatile uint32_t _e = K3; _e *= 0x119DE1F3u; _e ^= _e >> 16; (void)_e;
@@ -3081,32 +5444,216 @@ namespace cloakwork {
                 return data.data();
             }
 
-            CW_NOINLINE operator const wchar_t*() const { return get(); }
+            CW_NOINLINE operator const CharT*() const { return get(); }
 
-            ~encrypted_wstring() {
-                if (decrypted.load(CW_MO_RELAXED)) {
-                    CW_LOCK_GUARD(mutex);
-                    if (decrypted.load(CW_MO_RELAXED)) {
-                        auto& mutable_data = const_cast<std::array<wchar_t, N>&>(data);
-                        uint8_t bytes[BYTE_LEN];
-                        for (size_t i = 0; i < N; ++i) {
-                            bytes[i * 2]     = static_cast<uint8_t>(mutable_data[i] & 0xFF);
-                            bytes[i * 2 + 1] = static_cast<uint8_t>((mutable_data[i] >> 8) & 0xFF);
-                        }
-                        cipher::encrypt_buffer<K0, K1, K2, K3>(bytes, BYTE_LEN);
-                        for (size_t i = 0; i < N; ++i) {
-                            mutable_data[i] = static_cast<wchar_t>(bytes[i * 2])
-                                            | (static_cast<wchar_t>(bytes[i * 2 + 1]) << 8);
-                        }
-                        decrypted.store(false, CW_MO_RELEASE);
+            // plain -> ciphertext again; the destructor, or wipe_all() in trivial mode
+            void wipe_plaintext() const {
+                detail::encrypt_once(state, [this] {
+                    cipher::encrypt_units<K0, K1, K2, K3>(const_cast<std::array<CharT, N>&>(data).data(), N);
+                });
+            }
+
+#if CW_TRIVIAL_STRINGS
+            static void wipe_thunk(const void* self) {
+                static_cast<const basic_encrypted_string*>(self)->wipe_plaintext();
+            }
+#else
+            ~basic_encrypted_string() { wipe_plaintext(); }
+#endif
+        };
+
+        template<typename CharT, size_t N>
+        basic_encrypted_string(const CharT (&)[N]) -> basic_encrypted_string<CharT, N>;
+
+        template<size_t N,
+                 uint32_t K0 = CW_RANDOM_CT(), uint32_t K1 = CW_RANDOM_CT(),
+                 uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT()>
+        using encrypted_wstring = basic_encrypted_string<wchar_t, N, K0, K1, K2, K3>;
+
+        //
+        // large encrypted blobs (certificates, scripts, model headers).
+        // the source is a static constexpr byte array (#embed or a generated
+        // header) passed by reference. every CW_BLOB_CHUNK_SIZE chunk is its own
+        // constant evaluation, so multi-MB assets stay under the constexpr step
+        // limits, and at runtime chunks decrypt one at a time into a caller
+        // buffer - the whole asset is never plaintext at once.
+        //
+        namespace blob_detail {
+            // per-block whitening keyed by the absolute block index, so equal
+            // chunks don't encrypt to equal ciphertext
+            constexpr uint64_t block_tweak(uint32_t seed, uint64_t block) {
+                uint64_t x = (block + 1) * 0x9E3779B97F4A7C15ull ^ seed;
+                x ^= x >> 31;
+                x *= 0xBF58476D1CE4E5B9ull;
+                x ^= x >> 29;
+                return x;
+            }
+
+            template<typename ByteT>
+            constexpr void whiten(ByteT* data, size_t len, uint64_t first_block, uint32_t seed) {
+                for (size_t b = 0; b * 8 + 7 < len; ++b) {
+                    uint64_t t = block_tweak(seed, first_block + b);
+                    for (size_t j = 0; j < 8; ++j)
+                        data[b * 8 + j] = static_cast<ByteT>(static_cast<uint8_t>(data[b * 8 + j]) ^
+                            static_cast<uint8_t>(t >> (j * 8)));
+                }
+            }
+
+            // runtime inverse of whiten: one 64-bit xor per block. x86 is
+            // little-endian, so the word load lines up with the byte order above
+            CW_FORCEINLINE void unwhiten(uint8_t* data, size_t len, uint64_t first_block, uint32_t seed) {
+#if CW_SIMD
+                for (size_t b = 0; b * 8 + 7 < len; ++b) {
+                    uint64_t w;
+                    memcpy(&w, data + b * 8, 8);
+                    w ^= block_tweak(seed, first_block + b);
+                    memcpy(data + b * 8, &w, 8);
+                }
+#else
+                whiten(data, len, first_block, seed);
+#endif
+            }
+
+            constexpr size_t chunk_length(size_t total, size_t index) {
+                size_t offset = index * CW_BLOB_CHUNK_SIZE;
+                return total - offset < CW_BLOB_CHUNK_SIZE ? total - offset : CW_BLOB_CHUNK_SIZE;
+            }
+
+            template<const auto& Src, size_t Index,
+                     uint32_t K0, uint32_t K1, uint32_t K2, uint32_t K3>
+            struct chunk {
+                static constexpr size_t length = chunk_length(sizeof(Src), Index);
+
+                static constexpr std::array<uint8_t, length> encrypt() {
+                    std::array<uint8_t, length> out{};
+                    for (size_t i = 0; i < length; ++i)
+                        out[i] = static_cast<uint8_t>(Src[Index * CW_BLOB_CHUNK_SIZE + i]);
+                    whiten(out.data(), length, Index * (CW_BLOB_CHUNK_SIZE / 8), K0 ^ K3);
+                    cipher::encrypt_buffer<K0, K1, K2, K3>(out.data(), length, Index);
+                    return out;
+                }
+
+                static constexpr std::array<uint8_t, length> bytes = encrypt();
+            };
+        }
+
+        template<const auto& Src,
+                 uint32_t K0 = CW_RANDOM_CT(), uint32_t K1 = CW_RANDOM_CT(),
+                 uint32_t K2 = CW_RANDOM_CT(), uint32_t K3 = CW_RANDOM_CT()>
+        class encrypted_blob {
+            static_assert(sizeof(Src[0]) == 1, "CW_BLOB source must be a byte array");
+            static_assert(CW_BLOB_CHUNK_SIZE % 8 == 0, "CW_BLOB_CHUNK_SIZE must be a multiple of 8");
+
+            static constexpr size_t total = sizeof(Src);
+            static constexpr size_t count = (total + CW_BLOB_CHUNK_SIZE - 1) / CW_BLOB_CHUNK_SIZE;
+
+            template<size_t... I>
+            static constexpr std::array<const uint8_t*, count> make_table(std::index_sequence<I...>) {
+                return {{ blob_detail::chunk<Src, I, K0, K1, K2, K3>::bytes.data()... }};
+            }
+
+            static constexpr std::array<const uint8_t*, count> table =
+                make_table(std::make_index_sequence<count>{});
+
+        public:
+            static constexpr size_t chunk_size = CW_BLOB_CHUNK_SIZE;
+
+            static constexpr size_t size() { return total; }
+            static constexpr size_t chunk_count() { return count; }
+            static constexpr size_t chunk_length(size_t index) {
+                return index < count ? blob_detail::chunk_length(total, index) : 0;
+            }
+
+            // decrypts chunk `index` into out (chunk_size bytes), returns bytes written
+            size_t decrypt_chunk(size_t index, void* out) const {
+                if (index >= count) return 0;
+                uint8_t* dst = static_cast<uint8_t*>(out);
+                const uint8_t* src = table[index];
+                CW_LAUNDER(src);
+                size_t len = blob_detail::chunk_length(total, index);
+                memcpy(dst, src, len);
+                cipher::decrypt_buffer<K0, K1, K2, K3>(dst, len, index);
+                blob_detail::unwhiten(dst, len, index * (CW_BLOB_CHUNK_SIZE / 8), K0 ^ K3);
+                return len;
+            }
+
+            // random access: decrypts [offset, offset+len) into out, returns bytes written.
+            // whole chunks go straight into out, partial ones through a wiped stack chunk
+            size_t read(size_t offset, void* out, size_t len) const {
+                if (offset >= total) return 0;
+                if (len > total - offset) len = total - offset;
+                uint8_t* dst = static_cast<uint8_t*>(out);
+                size_t done = 0;
+                while (done < len) {
+                    size_t pos = offset + done;
+                    size_t index = pos / CW_BLOB_CHUNK_SIZE;
+                    size_t within = pos % CW_BLOB_CHUNK_SIZE;
+                    size_t clen = blob_detail::chunk_length(total, index);
+                    size_t n = clen - within < len - done ? clen - within : len - done;
+                    if (within == 0 && n == clen) {
+                        decrypt_chunk(index, dst + done);
+                    } else {
+                        uint8_t scratch[CW_BLOB_CHUNK_SIZE];
+                        decrypt_chunk(index, scratch);
+                        memcpy(dst + done, scratch + within, n);
+                        volatile uint8_t* wipe = scratch;
+                        for (size_t i = 0; i < clen; ++i) wipe[i] = 0;
+                    }
+                    done += n;
+                }
+                return done;
+            }
+
+            // streams every chunk through buffer (chunk_size bytes) and calls
+            // fn(const uint8_t* data, size_t len) for each; fn may return false to
+            // stop early. buffer is wiped before returning
+            template<typename Fn>
+            void for_each_chunk(void* buffer, Fn&& fn) const {
+                uint8_t* buf = static_cast<uint8_t*>(buffer);
+                for (size_t i = 0; i < count; ++i) {
+                    size_t len = decrypt_chunk(i, buf);
+                    if constexpr (std::is_same_v<decltype(fn(static_cast<const uint8_t*>(buf), len)), bool>) {
+                        if (!fn(static_cast<const uint8_t*>(buf), len)) break;
+                    } else {
+                        fn(static_cast<const uint8_t*>(buf), len);
                     }
                 }
+                volatile uint8_t* wipe = buf;
+                for (size_t i = 0; i < chunk_length(0); ++i) wipe[i] = 0;
             }
         };
+    }
 
-        template<size_t N>
-        encrypted_wstring(const wchar_t (&)[N]) -> encrypted_wstring<N>;
+#if CW_TRIVIAL_STRINGS
+    //
+    // re-encrypts every string decrypted since the last pass and returns how
+    // many; those sites decrypt again on next use. runs once at exit through
+    // wipe_guard. calling it on demand is only safe while no thread is still
+    // using a pointer it got from one of those strings.
+    //
+    inline size_t wipe_all() {
+        string_encrypt::detail::wipe_node* node =
+            string_encrypt::detail::wipe_head.exchange(nullptr, std::memory_order_acquire);
+        size_t count = 0;
+        while (node) {
+            // read next first: once wiped, the site can be decrypted and pushed again
+            string_encrypt::detail::wipe_node* next = node->next;
+            node->wipe(node->self);
+            node = next;
+            ++count;
+        }
+        return count;
+    }
+
+    namespace string_encrypt::detail {
+        struct wipe_at_exit {
+            ~wipe_at_exit() { wipe_all(); }
+        };
+
+        // the single static destructor left for strings in this mode
+        inline wipe_at_exit wipe_guard;
     }
+#endif
 
     //
     // per-site size padding injected into CW_STR wrapper lambdas.
@@ -3195,20 +5742,95 @@ namespace cloakwork {
                 _p += _q;
                 volatile uint32_t _r = static_cast<uint32_t>(_p ^ (_p >> 32)); (void)_r;
             }
-            CW_COMPILER_BARRIER();
+            CW_COMPILER_BARRIER();
+        }
+    }
+
+    // string encryption macros
+    // constinit ensures compile-time initialization (encrypted data in .rdata, not plaintext)
+// site is a local struct whose static get() holds the string object
+#if CW_STR_REGISTRY == 1
+#define CW_STR_REGISTER(site) \
+    CW_STR_REGISTRY_ENTRY constinit static cloakwork::string_encrypt::registry_entry _cw_reg = \
+        { &cloakwork::string_encrypt::detail::site_decrypt<site> }; \
+    CW_STR_REGISTRY_KEEP(_cw_reg)
+#elif CW_STR_REGISTRY == 2
+#define CW_STR_REGISTER(site) \
+    (void)cloakwork::string_encrypt::detail::registry_link<site>::linked
+#else
+#define CW_STR_REGISTER(site) ((void)0)
+#endif
+
+    //
+    // content-interned strings. the keys come from the literal's bytes and
+    // CW_SHARED_STRING_SEED only, so equal literals anywhere in the program name
+    // the same encrypted_literal - and through it one shared_string instance,
+    // one decrypt stub and one first-call decrypt. the template argument is the
+    // ciphertext, so symbol names never carry the plaintext.
+    //
+    namespace string_encrypt {
+        template<size_t N>
+        consteval uint64_t shared_hash(const char (&str)[N]) {
+#ifdef CW_SHARED_STRING_SEED
+            uint64_t h = 0xCBF29CE484222325ull ^ static_cast<uint64_t>(CW_SHARED_STRING_SEED);
+#else
+            static_assert(N == 0, "CW_STR_SHARED needs CW_SHARED_STRING_SEED defined to a "
+                                  "project-specific 64-bit value, identical in every translation unit");
+            uint64_t h = 0;
+#endif
+            for (size_t i = 0; i < N; ++i) {
+                h ^= static_cast<uint8_t>(str[i]);
+                h *= 0x100000001B3ull;
+            }
+            return h;
+        }
+
+        consteval uint32_t shared_key(uint64_t h, uint32_t lane) {
+            uint64_t x = h + (lane + 1) * 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<uint32_t>(x ^ (x >> 31));
         }
+
+        template<size_t N, uint64_t H>
+        using shared_literal = encrypted_literal<N,
+            shared_key(H, 0), shared_key(H, 1), shared_key(H, 2), shared_key(H, 3)>;
+
+        template<auto Lit>
+        inline constinit typename decltype(Lit)::string_type shared_string{Lit};
     }
 
-    // string encryption macros
-    // constinit ensures compile-time initialization (encrypted data in .rdata, not plaintext)
 #define CW_STR(s) \
     static_cast<const char*>(([]() CW_NOINLINE -> const char* { \
-        constinit static cloakwork::string_encrypt::encrypted_string<sizeof(s), \
-            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> enc(s); \
+        struct _cw_site { \
+            static CW_FORCEINLINE const char* get() { \
+                static constexpr cloakwork::string_encrypt::encrypted_literal<sizeof(s), \
+                    CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> lit(s); \
+                constinit static decltype(lit)::string_type enc(lit); \
+                return enc.get(); \
+            } \
+        }; \
+        CW_STR_REGISTER(_cw_site); \
         cloakwork::string_encrypt::size_pad<CW_RANDOM_CT()>(); \
-        return enc.get(); \
+        return _cw_site::get(); \
     }()))
 
+// opt-in dedup: identical literals share one ciphertext and one decrypted copy.
+// the wrapper is inlined and only carries this site's registry entry, so every
+// site registers (see CW_STR_REGISTER); they all resolve to the one object
+#define CW_STR_SHARED(s) \
+    ([]() -> const char* { \
+        struct _cw_site { \
+            static CW_FORCEINLINE const char* get() { \
+                constexpr cloakwork::string_encrypt::shared_literal<sizeof(s), \
+                    cloakwork::string_encrypt::shared_hash(s)> _cw_lit(s); \
+                return cloakwork::string_encrypt::shared_string<_cw_lit>.get(); \
+            } \
+        }; \
+        CW_STR_REGISTER(_cw_site); \
+        return _cw_site::get(); \
+    }())
+
 #define CW_STR_LAYERED(s) \
     static_cast<const char*>(([]() CW_NOINLINE -> const char* { \
         constinit static cloakwork::string_encrypt::layered_encrypted_string<sizeof(s), \
@@ -3217,22 +5839,89 @@ namespace cloakwork {
         return enc.get(); \
     }()))
 
+// same, with the re-key interval chosen per site (accesses per thread, 0 = never)
+#define CW_STR_LAYERED_N(s, interval) \
+    static_cast<const char*>(([]() CW_NOINLINE -> const char* { \
+        constinit static cloakwork::string_encrypt::layered_encrypted_string<sizeof(s), \
+            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), (interval)> enc(s); \
+        cloakwork::string_encrypt::size_pad<CW_RANDOM_CT()>(); \
+        return enc.get(); \
+    }()))
+
 #define CW_STR_STACK(s) \
     ([&]() CW_NOINLINE { \
-        constinit static cloakwork::string_encrypt::encrypted_string<sizeof(s), \
-            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> enc(s); \
+        static constexpr cloakwork::string_encrypt::encrypted_literal<sizeof(s), \
+            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> lit(s); \
         cloakwork::string_encrypt::size_pad<CW_RANDOM_CT()>(); \
-        return cloakwork::string_encrypt::stack_encrypted_string<sizeof(s)>(enc); \
+        return cloakwork::string_encrypt::stack_encrypted_string<sizeof(s)>(lit); \
     }())
 
-#define CW_WSTR(s) \
-    static_cast<const wchar_t*>(([]() CW_NOINLINE -> const wchar_t* { \
-        constinit static cloakwork::string_encrypt::encrypted_wstring<sizeof(s)/sizeof(wchar_t), \
-            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> enc(s); \
+// scoped plaintext: fn gets a std::string_view that is wiped when fn returns
+// usage: CW_WITH_DECRYPTED("secret", [&](std::string_view v) { send(v); });
+#define CW_WITH_DECRYPTED(s, fn) \
+    ([&]() -> decltype(auto) { \
+        static constexpr cloakwork::string_encrypt::encrypted_literal<sizeof(s), \
+            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> lit(s); \
+        return cloakwork::string_encrypt::with_decrypted(lit, fn); \
+    }())
+
+// compare runtime input with a literal that is never decrypted to memory
+// usage: if (CW_STR_EQ(cmd, "shutdown")) ...
+//        if (CW_STR_STARTS_WITH(header, "Bearer ")) ...
+// CW_STR_EQ_CT takes the same time for any input of the literal's length
+#define CW_STR_EQ(in, s) \
+    ([&]() -> bool { \
+        static constexpr cloakwork::string_encrypt::encrypted_literal<sizeof(s), \
+            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> lit(s); \
+        return lit.equals(std::string_view(in)); \
+    }())
+
+#define CW_STR_EQ_CT(in, s) \
+    ([&]() -> bool { \
+        static constexpr cloakwork::string_encrypt::encrypted_literal<sizeof(s), \
+            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> lit(s); \
+        return lit.template equals<true>(std::string_view(in)); \
+    }())
+
+#define CW_STR_STARTS_WITH(in, s) \
+    ([&]() -> bool { \
+        static constexpr cloakwork::string_encrypt::encrypted_literal<sizeof(s), \
+            CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> lit(s); \
+        return lit.is_prefix_of(std::string_view(in)); \
+    }())
+
+// shared body for the non-char literals; T is the code-unit type
+#define CW_UNIT_STR(T, s) \
+    static_cast<const T*>(([]() CW_NOINLINE -> const T* { \
+        struct _cw_site { \
+            static CW_FORCEINLINE const T* get() { \
+                constinit static cloakwork::string_encrypt::basic_encrypted_string<T, sizeof(s)/sizeof(T), \
+                    CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()> enc(s); \
+                return enc.get(); \
+            } \
+        }; \
+        CW_STR_REGISTER(_cw_site); \
         cloakwork::string_encrypt::size_pad<CW_RANDOM_CT()>(); \
-        return enc.get(); \
+        return _cw_site::get(); \
     }()))
 
+#define CW_WSTR(s) CW_UNIT_STR(wchar_t, s)
+#define CW_U16STR(s) CW_UNIT_STR(char16_t, s)
+#define CW_U32STR(s) CW_UNIT_STR(char32_t, s)
+#ifdef __cpp_char8_t
+    #define CW_U8STR(s) CW_UNIT_STR(char8_t, s)
+#endif
+
+// encrypted blob over a static constexpr byte array, decrypted chunk by chunk
+// usage: static constexpr unsigned char cert_der[] = {
+//            #embed "cert.der"
+//        };
+//        auto cert = CW_BLOB(cert_der);
+//        cert.for_each_chunk(buf, [&](const uint8_t* p, size_t n) { sink(p, n); });
+#define CW_BLOB(arr) \
+    (cloakwork::string_encrypt::encrypted_blob<arr, \
+        CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT(), CW_RANDOM_CT()>{})
+
 // stack string builder - builds string char-by-char, never exists as literal in binary
 // usage: CW_STACK_STR(name, 'h','e','l','l','o','\0')
 #define CW_STACK_STR(name, ...) \
@@ -3246,13 +5935,699 @@ namespace cloakwork {
     } while(0)
 
 #else
+    // same interface as encrypted_blob, reading the source directly
+    namespace string_encrypt {
+        template<const auto& Src>
+        struct plain_blob {
+            static constexpr size_t chunk_size = CW_BLOB_CHUNK_SIZE;
+            static constexpr size_t size() { return sizeof(Src); }
+            static constexpr size_t chunk_count() { return (sizeof(Src) + chunk_size - 1) / chunk_size; }
+            static constexpr size_t chunk_length(size_t index) {
+                return index >= chunk_count() ? 0 :
+                    (sizeof(Src) - index * chunk_size < chunk_size ? sizeof(Src) - index * chunk_size : chunk_size);
+            }
+            size_t decrypt_chunk(size_t index, void* out) const {
+                size_t len = chunk_length(index);
+                if (len) memcpy(out, &Src[index * chunk_size], len);
+                return len;
+            }
+            size_t read(size_t offset, void* out, size_t len) const {
+                if (offset >= sizeof(Src)) return 0;
+                if (len > sizeof(Src) - offset) len = sizeof(Src) - offset;
+                memcpy(out, &Src[offset], len);
+                return len;
+            }
+            template<typename Fn>
+            void for_each_chunk(void*, Fn&& fn) const {
+                for (size_t i = 0; i < chunk_count(); ++i) {
+                    const uint8_t* p = reinterpret_cast<const uint8_t*>(&Src[i * chunk_size]);
+                    if constexpr (std::is_same_v<decltype(fn(p, chunk_length(i))), bool>) {
+                        if (!fn(p, chunk_length(i))) break;
+                    } else {
+                        fn(p, chunk_length(i));
+                    }
+                }
+            }
+        };
+    }
+
+    namespace string_encrypt {
+        // nothing is encrypted, so there is nothing to warm up
+        inline size_t predecrypt_all(unsigned = 0) { return 0; }
+    }
+
+    #if CW_TRIVIAL_STRINGS
+        inline size_t wipe_all() { return 0; }
+    #endif
+
+    #define CW_BLOB(arr) (cloakwork::string_encrypt::plain_blob<arr>{})
     #define CW_STR(s) (s)
+    #define CW_STR_SHARED(s) (s)
     #define CW_STR_LAYERED(s) (s)
+    #define CW_STR_LAYERED_N(s, interval) (s)
     #define CW_STR_STACK(s) (s)
+    #if !CW_KERNEL_MODE
+        #define CW_WITH_DECRYPTED(s, fn) (fn(std::string_view(s, sizeof(s) - 1)))
+        #define CW_STR_EQ(in, s) (std::string_view(in) == std::string_view(s, sizeof(s) - 1))
+        #define CW_STR_EQ_CT(in, s) (std::string_view(in) == std::string_view(s, sizeof(s) - 1))
+        #define CW_STR_STARTS_WITH(in, s) (std::string_view(in).starts_with(std::string_view(s, sizeof(s) - 1)))
+    #endif
     #define CW_WSTR(s) (s)
+    #define CW_U16STR(s) (s)
+    #define CW_U32STR(s) (s)
+    #ifdef __cpp_char8_t
+        #define CW_U8STR(s) (s)
+    #endif
     #define CW_STACK_STR(name, ...) char name[] = { __VA_ARGS__ }
 #endif
 
+// length-aware views: the size comes from the literal, so no strlen per use.
+// embedded nulls are kept; the terminator is not part of the view.
+#if !CW_KERNEL_MODE
+    #define CW_SV(s) (std::string_view(CW_STR(s), sizeof(s) - 1))
+    #define CW_WSV(s) (std::wstring_view(CW_WSTR(s), sizeof(s) / sizeof(wchar_t) - 1))
+#endif
+
+//
+// heap-free formatting with an encrypted format string. the format decrypts
+// onto the stack (CW_WITH_DECRYPTED), std::vformat_to writes into whatever
+// the caller's iterator points at, and the stack copy is wiped on return.
+// the format is still checked against the argument types at compile time.
+// needs <format> (gcc 13+, clang 17+ with libc++, msvc 19.29+); without it
+// the macros are not defined. the bounded iterator doesn't, so it is there
+// (and tested) either way.
+//
+#if !CW_KERNEL_MODE
+    namespace fmt_detail {
+        // output iterator that stops writing after n chars but keeps counting,
+        // so the result matches std::format_to_n
+        template<typename OutIt>
+        struct bounded_state {
+            OutIt out;
+            std::iter_difference_t<OutIt> left;
+            std::iter_difference_t<OutIt> count = 0;
+        };
+
+        template<typename OutIt>
+        struct bounded_iterator {
+            using difference_type = ptrdiff_t;
+            bounded_state<OutIt>* s;
+
+            const bounded_iterator& operator*() const { return *this; }
+            const bounded_iterator& operator=(char c) const {
+                if (s->left > 0) { *s->out = c; ++s->out; --s->left; }
+                ++s->count;
+                return *this;
+            }
+            bounded_iterator& operator++() { return *this; }
+            bounded_iterator operator++(int) { return *this; }
+        };
+
+#ifdef __cpp_lib_format
+        template<typename OutIt>
+        std::format_to_n_result<OutIt> vformat_to_n(OutIt out, std::iter_difference_t<OutIt> n,
+                                                    std::string_view fmt, std::format_args args) {
+            bounded_state<OutIt> state{ std::move(out), n > 0 ? n : 0 };
+            std::vformat_to(bounded_iterator<OutIt>{ &state }, fmt, args);
+            return { std::move(state.out), state.count };
+        }
+#endif
+    }
+#endif
+
+#if !CW_KERNEL_MODE && defined(__cpp_lib_format)
+// usage: char buf[128]; char* end = CW_FMT_TO(buf, "user {} failed {}", name, code);
+//        CW_FMT_TO(std::back_inserter(line), "retry {}", n);
+// returns the iterator past the last char written
+#define CW_FMT_TO(out, fmt, ...) \
+    ([&](const auto&... _cw_a) { \
+        static_assert((std::format_string<decltype(_cw_a)...>(fmt), true)); \
+        return CW_WITH_DECRYPTED(fmt, [&](std::string_view _cw_f) { \
+            return std::vformat_to(out, _cw_f, std::make_format_args(_cw_a...)); \
+        }); \
+    }(__VA_ARGS__))
+
+// writes at most n chars; returns std::format_to_n_result { out, full size }
+// usage: auto r = CW_FMT_TO_N(buf, sizeof(buf) - 1, "{}:{}", host, port); *r.out = 0;
+#define CW_FMT_TO_N(out, n, fmt, ...) \
+    ([&](const auto&... _cw_a) { \
+        static_assert((std::format_string<decltype(_cw_a)...>(fmt), true)); \
+        return CW_WITH_DECRYPTED(fmt, [&](std::string_view _cw_f) { \
+            return cloakwork::fmt_detail::vformat_to_n(out, n, _cw_f, std::make_format_args(_cw_a...)); \
+        }); \
+    }(__VA_ARGS__))
+#endif
+
+//
+// deferred binary logging (CW_LOG). every site has a compile-time id and its
+// format string is encrypted at compile time with xtea-ctr under CW_LOG_KEY;
+// the process never decrypts it. at runtime a call writes the site id, a
+// timestamp and its binary-encoded args into the calling thread's ring
+// (single producer / single consumer, no locks) and drain() streams the
+// rings out together with the manifest of sites seen so far. the offline
+// decoder (CW_LOG_DECODER, tools/cw_logdecode.cpp) rebuilds the text.
+//
+// sites register themselves on first use rather than through a linker
+// section, because gcc drops section attributes on statics in templates
+// and a log site inside a template must still be decodable.
+//
+#if !CW_KERNEL_MODE
+    namespace logging {
+        enum class level : uint8_t { trace, debug, info, warn, error };
+
+        namespace detail {
+            constexpr uint64_t mix64(uint64_t x) {
+                x += 0x9E3779B97F4A7C15ull;
+                x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+                x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+                return x ^ (x >> 31);
+            }
+
+            constexpr void xtea_block(uint32_t& v0, uint32_t& v1, const uint32_t (&k)[4]) {
+                uint32_t sum = 0;
+                for (int i = 0; i < 32; ++i) {
+                    v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + k[sum & 3]);
+                    sum += 0x9E3779B9u;
+                    v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + k[(sum >> 11) & 3]);
+                }
+            }
+
+            // counter mode, so the same call encrypts and decrypts
+            constexpr void xtea_ctr(uint8_t* data, size_t len, uint64_t nonce, uint64_t key) {
+                uint64_t a = mix64(key), b = mix64(key ^ 0xA5A5A5A5A5A5A5A5ull);
+                const uint32_t k[4] = {
+                    static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32),
+                    static_cast<uint32_t>(b), static_cast<uint32_t>(b >> 32) };
+                for (size_t off = 0; off < len; off += 8) {
+                    uint64_t ctr = nonce ^ (off / 8);
+                    uint32_t v0 = static_cast<uint32_t>(ctr), v1 = static_cast<uint32_t>(ctr >> 32);
+                    xtea_block(v0, v1, k);
+                    for (size_t j = 0; j < 8 && off + j < len; ++j)
+                        data[off + j] ^= static_cast<uint8_t>((j < 4 ? v0 >> (j * 8) : v1 >> ((j - 4) * 8)));
+                }
+            }
+
+            // the arg types are part of the id: a site inside a template logs
+            // different encodings per instantiation
+            template<size_t F, size_t N, size_t T>
+            consteval uint64_t site_id(const char (&file)[F], uint32_t line, const char (&fmt)[N],
+                                       const char (&types)[T]) {
+                uint64_t h = 0xCBF29CE484222325ull;
+                for (size_t i = 0; i < F; ++i) { h ^= static_cast<uint8_t>(file[i]); h *= 0x100000001B3ull; }
+                h ^= line; h *= 0x100000001B3ull;
+                for (size_t i = 0; i < N; ++i) { h ^= static_cast<uint8_t>(fmt[i]); h *= 0x100000001B3ull; }
+                for (size_t i = 0; i < T; ++i) { h ^= static_cast<uint8_t>(types[i]); h *= 0x100000001B3ull; }
+                return mix64(h) | 1u;  // never 0
+            }
+
+            template<size_t N>
+            consteval size_t count_placeholders(const char (&fmt)[N]) {
+                size_t n = 0;
+                for (size_t i = 0; i + 1 < N; ++i) {
+                    if (fmt[i] == '{' && fmt[i + 1] == '{') ++i;
+                    else if (fmt[i] == '{' && fmt[i + 1] == '}') { ++n; ++i; }
+                }
+                return n;
+            }
+
+            template<size_t N>
+            consteval std::array<uint8_t, N - 1> seal(const char (&fmt)[N], uint64_t id) {
+                std::array<uint8_t, N - 1> out{};
+                for (size_t i = 0; i + 1 < N; ++i) out[i] = static_cast<uint8_t>(fmt[i]);
+#if CW_ENABLE_STRING_ENCRYPTION && defined(CW_LOG_KEY)
+                xtea_ctr(out.data(), N - 1, id, CW_LOG_KEY);
+#elif CW_ENABLE_STRING_ENCRYPTION
+                static_assert(N == 0, "CW_LOG needs CW_LOG_KEY defined to a project-specific 64-bit "
+                                      "value; the decoder is given the same value with --key");
+                (void)id;
+#else
+                (void)id;
+#endif
+                return out;
+            }
+
+            // one-byte arg type codes, fixed per site
+            template<typename T>
+            consteval char type_code() {
+                using U = std::remove_cv_t<std::remove_reference_t<T>>;
+                if constexpr (std::is_same_v<U, bool>) return 'b';
+                else if constexpr (std::is_same_v<U, char>) return 'c';
+                else if constexpr (std::is_enum_v<U>) return 'i';
+                else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) return 'i';
+                else if constexpr (std::is_integral_v<U>) return 'u';
+                else if constexpr (std::is_floating_point_v<U>) return 'f';
+                else if constexpr (std::is_null_pointer_v<U>) return 's';  // "(null)", like a null const char*
+                else if constexpr (std::is_convertible_v<const U&, std::string_view>) return 's';
+                else if constexpr (std::is_pointer_v<U>) return 'p';
+                else static_assert(sizeof(U) == 0, "CW_LOG: unsupported argument type");
+            }
+
+            // manifest entry, one per call site
+            struct site {
+                std::atomic<site*> next;
+                uint64_t id;
+                const uint8_t* fmt;
+                uint32_t fmt_len;
+                uint8_t lvl;
+                uint8_t encrypted;
+                uint8_t nargs;
+                const char* types;
+                std::atomic<uint32_t> registered;
+            };
+
+            inline std::atomic<site*> sites{nullptr};
+
+            CW_NOINLINE inline void register_site(site* s) {
+                uint32_t expected = 0;
+                if (!s->registered.compare_exchange_strong(expected, 1, std::memory_order_relaxed))
+                    return;
+                site* head = sites.load(std::memory_order_relaxed);
+                do {
+                    s->next.store(head, std::memory_order_relaxed);
+                } while (!sites.compare_exchange_weak(head, s,
+                             std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            static_assert((CW_LOG_RING_SIZE & (CW_LOG_RING_SIZE - 1)) == 0,
+                          "CW_LOG_RING_SIZE must be a power of two");
+
+            // per-thread spsc byte ring. records are [id u64][tsc u64][len u32][payload]
+            struct ring {
+                ring* next = nullptr;               // every ring ever made, never unlinked
+                std::atomic<uint32_t> owned{1};     // 0 once the owning thread exits
+                uint32_t index = 0;                 // thread ordinal in the output
+                alignas(64) std::atomic<uint64_t> head{0};
+                std::atomic<uint64_t> dropped{0};
+                alignas(64) std::atomic<uint64_t> tail{0};
+                uint64_t dropped_seen = 0;
+                alignas(64) uint8_t data[CW_LOG_RING_SIZE];
+
+                CW_FORCEINLINE void put(uint64_t& pos, const void* src, size_t n) {
+                    size_t at = static_cast<size_t>(pos) & (CW_LOG_RING_SIZE - 1);
+                    size_t first = n < CW_LOG_RING_SIZE - at ? n : CW_LOG_RING_SIZE - at;
+                    memcpy(data + at, src, first);
+                    if (first < n) memcpy(data, static_cast<const uint8_t*>(src) + first, n - first);
+                    pos += n;
+                }
+
+                void get(uint64_t pos, void* dst, size_t n) const {
+                    size_t at = static_cast<size_t>(pos) & (CW_LOG_RING_SIZE - 1);
+                    size_t first = n < CW_LOG_RING_SIZE - at ? n : CW_LOG_RING_SIZE - at;
+                    memcpy(dst, data + at, first);
+                    if (first < n) memcpy(static_cast<uint8_t*>(dst) + first, data, n - first);
+                }
+            };
+
+            inline std::atomic<ring*> rings{nullptr};
+            inline std::atomic<uint32_t> ring_count{0};
+
+            // hands a ring to a new thread, reusing one whose thread has exited
+            CW_NOINLINE inline ring* acquire_ring() {
+                for (ring* r = rings.load(std::memory_order_acquire); r; r = r->next) {
+                    uint32_t expected = 0;
+                    if (r->owned.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+                        return r;
+                }
+                ring* r = new ring();
+                r->index = ring_count.fetch_add(1, std::memory_order_relaxed);
+                ring* head = rings.load(std::memory_order_relaxed);
+                do {
+                    r->next = head;
+                } while (!rings.compare_exchange_weak(head, r,
+                             std::memory_order_release, std::memory_order_relaxed));
+                return r;
+            }
+
+            struct ring_owner {
+                ring* r = nullptr;
+                ~ring_owner() { if (r) r->owned.store(0, std::memory_order_release); }
+            };
+
+            CW_FORCEINLINE ring* thread_ring() {
+                thread_local ring_owner owner;
+                if (!owner.r) owner.r = acquire_ring();
+                return owner.r;
+            }
+
+            // an argument flattened for the ring: a scalar, or a string copied by value
+            struct packed_arg {
+                uint64_t bits;
+                const char* str;
+                uint32_t len;
+            };
+
+            static constexpr uint32_t max_string = CW_LOG_RING_SIZE / 8;
+
+            template<typename T>
+            CW_FORCEINLINE packed_arg pack(const T& v) {
+                constexpr char code = type_code<T>();
+                if constexpr (code == 's') {
+                    std::string_view sv;
+                    if constexpr (std::is_null_pointer_v<std::decay_t<T>>)
+                        sv = std::string_view("(null)");
+                    else if constexpr (std::is_pointer_v<std::decay_t<T>>)
+                        sv = v ? std::string_view(v) : std::string_view("(null)");
+                    else
+                        sv = std::string_view(v);
+                    uint32_t len = sv.size() < max_string ? static_cast<uint32_t>(sv.size()) : max_string;
+                    return { 0, sv.data(), len };
+                } else if constexpr (code == 'f') {
+                    return { std::bit_cast<uint64_t>(static_cast<double>(v)), nullptr, 0 };
+                } else if constexpr (code == 'p') {
+                    return { static_cast<uint64_t>(reinterpret_cast<uintptr_t>(v)), nullptr, 0 };
+                } else if constexpr (code == 'b' || code == 'c') {
+                    return { static_cast<uint64_t>(static_cast<uint8_t>(v)), nullptr, 0 };
+                } else {
+                    return { static_cast<uint64_t>(v), nullptr, 0 };
+                }
+            }
+
+            template<char Code>
+            CW_FORCEINLINE uint32_t packed_size(const packed_arg& a) {
+                if constexpr (Code == 's') return 4 + a.len;
+                else if constexpr (Code == 'b' || Code == 'c') return 1;
+                else return 8;
+            }
+
+            template<char Code>
+            CW_FORCEINLINE void put_arg(ring* r, uint64_t& pos, const packed_arg& a) {
+                if constexpr (Code == 's') {
+                    r->put(pos, &a.len, 4);
+                    r->put(pos, a.str, a.len);
+                } else if constexpr (Code == 'b' || Code == 'c') {
+                    uint8_t b = static_cast<uint8_t>(a.bits);
+                    r->put(pos, &b, 1);
+                } else {
+                    r->put(pos, &a.bits, 8);
+                }
+            }
+
+            template<typename... Args>
+            CW_FORCEINLINE void write(site& s, const Args&... args) {
+                if (!s.registered.load(std::memory_order_relaxed)) register_site(&s);
+                ring* r = thread_ring();
+                uint64_t tsc = intrin::rdtsc();
+                packed_arg packed[sizeof...(Args) + 1] = { pack(args)... };
+                uint32_t payload = 0;
+                {
+                    size_t i = 0;
+                    ((payload += packed_size<type_code<Args>()>(packed[i++])), ...);
+                }
+                uint64_t head = r->head.load(std::memory_order_relaxed);
+                uint64_t tail = r->tail.load(std::memory_order_acquire);
+                if (CW_LOG_RING_SIZE - (head - tail) < 20u + payload) {
+                    r->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                uint64_t pos = head;
+                r->put(pos, &s.id, 8);
+                r->put(pos, &tsc, 8);
+                r->put(pos, &payload, 4);
+                {
+                    size_t i = 0;
+                    (put_arg<type_code<Args>()>(r, pos, packed[i++]), ...);
+                }
+                r->head.store(pos, std::memory_order_release);
+            }
+
+            inline void append(std::vector<uint8_t>& out, const void* p, size_t n) {
+                const uint8_t* b = static_cast<const uint8_t*>(p);
+                out.insert(out.end(), b, b + n);
+            }
+
+            inline site* manifest_sent = nullptr;
+        }
+
+        //
+        // drains every thread's ring into sink(const uint8_t* data, size_t len)
+        // and returns the number of records. call it from one thread only (it
+        // is the single consumer). the stream is a sequence of tagged frames:
+        //   'C' tsc u64, unix ns u64                     clock sample, one per drain
+        //   'M' id u64, level u8, encrypted u8, nargs u8, types[nargs],
+        //       fmt_len u32, fmt[fmt_len]                site seen for the first time
+        //   'D' thread u32, count u64                    records dropped on a full ring
+        //   'L' thread u32, id u64, tsc u64, len u32, payload[len]
+        // all integers little-endian.
+        //
+        template<typename Sink>
+        size_t drain(Sink&& sink) {
+            std::vector<uint8_t> out;
+            out.reserve(4096);
+
+            uint64_t tsc = intrin::rdtsc();
+            uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            out.push_back('C');
+            detail::append(out, &tsc, 8);
+            detail::append(out, &now, 8);
+
+            // sites are pushed at the head, so everything before the last head we sent is new
+            detail::site* head = detail::sites.load(std::memory_order_acquire);
+            for (detail::site* s = head; s && s != detail::manifest_sent;
+                 s = s->next.load(std::memory_order_relaxed)) {
+                out.push_back('M');
+                detail::append(out, &s->id, 8);
+                out.push_back(s->lvl);
+                out.push_back(s->encrypted);
+                out.push_back(s->nargs);
+                detail::append(out, s->types, s->nargs);
+                detail::append(out, &s->fmt_len, 4);
+                detail::append(out, s->fmt, s->fmt_len);
+            }
+            detail::manifest_sent = head;
+
+            size_t records = 0;
+            for (detail::ring* r = detail::rings.load(std::memory_order_acquire); r; r = r->next) {
+                uint64_t dropped = r->dropped.load(std::memory_order_relaxed);
+                if (dropped != r->dropped_seen) {
+                    uint64_t delta = dropped - r->dropped_seen;
+                    out.push_back('D');
+                    detail::append(out, &r->index, 4);
+                    detail::append(out, &delta, 8);
+                    r->dropped_seen = dropped;
+                }
+
+                uint64_t tail = r->tail.load(std::memory_order_relaxed);
+                uint64_t end = r->head.load(std::memory_order_acquire);
+                while (tail < end) {
+                    uint8_t hdr[20];
+                    r->get(tail, hdr, 20);
+                    uint32_t len;
+                    memcpy(&len, hdr + 16, 4);
+                    out.push_back('L');
+                    detail::append(out, &r->index, 4);
+                    detail::append(out, hdr, 20);
+                    size_t at = out.size();
+                    out.resize(at + len);
+                    r->get(tail + 20, out.data() + at, len);
+                    tail += 20u + len;
+                    ++records;
+                }
+                r->tail.store(tail, std::memory_order_release);
+
+                if (out.size() >= 65536) {
+                    sink(static_cast<const uint8_t*>(out.data()), out.size());
+                    out.clear();
+                }
+            }
+            if (!out.empty()) sink(static_cast<const uint8_t*>(out.data()), out.size());
+            return records;
+        }
+
+#ifdef CW_LOG_DECODER
+        //
+        // offline side: turns a drained stream back into text, one line per record.
+        // only the decoder tool needs this, define CW_LOG_DECODER before including.
+        //
+        namespace decoder_detail {
+            struct site_info {
+                uint8_t lvl = 0;
+                std::string types;
+                std::string fmt;
+            };
+
+            inline const char* level_name(uint8_t l) {
+                static const char* names[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+                return l < 5 ? names[l] : "?";
+            }
+
+            struct reader {
+                const uint8_t* p;
+                const uint8_t* end;
+                bool ok = true;
+
+                bool need(size_t n) { if (static_cast<size_t>(end - p) < n) ok = false; return ok; }
+                void skip(size_t n) { if (need(n)) p += n; }
+                template<typename T> T take() {
+                    T v{};
+                    if (need(sizeof(T))) { memcpy(&v, p, sizeof(T)); p += sizeof(T); }
+                    return v;
+                }
+                std::string take_string(size_t n) {
+                    if (!need(n)) return {};
+                    std::string s(reinterpret_cast<const char*>(p), n);
+                    p += n;
+                    return s;
+                }
+            };
+
+            inline std::string render_arg(char type, reader& in) {
+                char buf[64];
+                switch (type) {
+                case 'b': return in.take<uint8_t>() ? "true" : "false";
+                case 'c': return std::string(1, static_cast<char>(in.take<uint8_t>()));
+                case 'i': snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(in.take<int64_t>())); return buf;
+                case 'u': snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(in.take<uint64_t>())); return buf;
+                case 'f': snprintf(buf, sizeof(buf), "%g", std::bit_cast<double>(in.take<uint64_t>())); return buf;
+                case 'p': snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(in.take<uint64_t>())); return buf;
+                case 's': { uint32_t n = in.take<uint32_t>(); return in.take_string(n); }
+                default: in.ok = false; return {};
+                }
+            }
+
+            inline std::string render(const site_info& s, reader& in) {
+                std::string out;
+                size_t arg = 0;
+                for (size_t i = 0; i < s.fmt.size(); ++i) {
+                    char c = s.fmt[i];
+                    if ((c == '{' || c == '}') && i + 1 < s.fmt.size() && s.fmt[i + 1] == c) {
+                        out += c; ++i;
+                    } else if (c == '{' && i + 1 < s.fmt.size() && s.fmt[i + 1] == '}') {
+                        if (arg < s.types.size()) out += render_arg(s.types[arg++], in);
+                        ++i;
+                    } else {
+                        out += c;
+                    }
+                }
+                return out;
+            }
+        }
+
+        //
+        // decodes a complete drained stream. lines look like
+        //   [12.345678] T0 INFO  accepted 7 from host
+        // where the time is seconds since the first clock sample, or raw ticks
+        // when fewer than two samples exist. key must match the producer's CW_LOG_KEY.
+        //
+        inline std::vector<std::string> decode(const uint8_t* data, size_t len, uint64_t key) {
+            using namespace decoder_detail;
+            std::unordered_map<uint64_t, site_info> sites;
+            std::vector<std::pair<uint64_t, uint64_t>> clocks;
+            reader in{ data, data + len };
+
+            // first pass collects the manifest and clock samples so records can
+            // precede the manifest entry of a site registered mid-drain
+            while (in.ok && in.p < in.end) {
+                uint8_t tag = in.take<uint8_t>();
+                if (tag == 'C') {
+                    uint64_t tsc = in.take<uint64_t>(), ns = in.take<uint64_t>();
+                    clocks.emplace_back(tsc, ns);
+                } else if (tag == 'M') {
+                    uint64_t id = in.take<uint64_t>();
+                    site_info s;
+                    s.lvl = in.take<uint8_t>();
+                    uint8_t encrypted = in.take<uint8_t>();
+                    uint8_t nargs = in.take<uint8_t>();
+                    s.types = in.take_string(nargs);
+                    uint32_t n = in.take<uint32_t>();
+                    s.fmt = in.take_string(n);
+                    if (encrypted)
+                        detail::xtea_ctr(reinterpret_cast<uint8_t*>(s.fmt.data()), s.fmt.size(), id, key);
+                    sites[id] = std::move(s);
+                } else if (tag == 'D') {
+                    in.skip(12);
+                } else if (tag == 'L') {
+                    in.skip(20);
+                    in.skip(in.take<uint32_t>());
+                } else {
+                    in.ok = false;
+                }
+            }
+
+            double ticks_per_sec = 0;
+            if (clocks.size() >= 2 && clocks.back().first != clocks.front().first &&
+                clocks.back().second != clocks.front().second) {
+                ticks_per_sec = static_cast<double>(clocks.back().first - clocks.front().first) * 1e9 /
+                                static_cast<double>(clocks.back().second - clocks.front().second);
+            }
+            uint64_t base = clocks.empty() ? 0 : clocks.front().first;
+
+            std::vector<std::string> lines;
+            in = reader{ data, data + len };
+            char prefix[96];
+            while (in.ok && in.p < in.end) {
+                uint8_t tag = in.take<uint8_t>();
+                if (tag == 'C') {
+                    in.skip(16);
+                } else if (tag == 'M') {
+                    in.skip(10);
+                    in.skip(in.take<uint8_t>());
+                    in.skip(in.take<uint32_t>());
+                } else if (tag == 'D') {
+                    uint32_t thread = in.take<uint32_t>();
+                    uint64_t count = in.take<uint64_t>();
+                    snprintf(prefix, sizeof(prefix), "T%u dropped %llu records", thread,
+                             static_cast<unsigned long long>(count));
+                    lines.emplace_back(prefix);
+                } else if (tag == 'L') {
+                    uint32_t thread = in.take<uint32_t>();
+                    uint64_t id = in.take<uint64_t>();
+                    uint64_t tsc = in.take<uint64_t>();
+                    uint32_t n = in.take<uint32_t>();
+                    if (!in.need(n)) break;
+                    reader payload{ in.p, in.p + n };
+                    in.skip(n);
+
+                    if (ticks_per_sec > 0)
+                        snprintf(prefix, sizeof(prefix), "[%.6f] T%u ",
+                                 static_cast<double>(static_cast<int64_t>(tsc - base)) / ticks_per_sec, thread);
+                    else
+                        snprintf(prefix, sizeof(prefix), "[%llu] T%u ",
+                                 static_cast<unsigned long long>(tsc), thread);
+
+                    auto it = sites.find(id);
+                    if (it == sites.end()) {
+                        char unknown[48];
+                        snprintf(unknown, sizeof(unknown), "<unknown site %016llx>",
+                                 static_cast<unsigned long long>(id));
+                        lines.push_back(std::string(prefix) + unknown);
+                        continue;
+                    }
+                    std::string line = prefix;
+                    line += level_name(it->second.lvl);
+                    line += ' ';
+                    line += render(it->second, payload);
+                    lines.push_back(std::move(line));
+                } else {
+                    break;
+                }
+            }
+            return lines;
+        }
+#endif
+    }
+
+// usage: CW_LOG(info, "accepted {} from {}", fd, peer_name);
+// levels: trace, debug, info, warn, error. placeholders are {} ({{ and }} escape).
+// args: integers, enums, bool, char, floating point, pointers, anything that
+// converts to std::string_view (copied into the ring, up to CW_LOG_RING_SIZE/8)
+#define CW_LOG(lvl, fmt, ...) \
+    [&](const auto&... _cw_a) { \
+        if constexpr (static_cast<int>(cloakwork::logging::level::lvl) >= CW_LOG_MIN_LEVEL) { \
+            static_assert(cloakwork::logging::detail::count_placeholders(fmt) == sizeof...(_cw_a), \
+                          "CW_LOG: placeholder count does not match argument count"); \
+            static constexpr char _cw_types[] = { cloakwork::logging::detail::type_code<decltype(_cw_a)>()..., 0 }; \
+            static constexpr uint64_t _cw_id = cloakwork::logging::detail::site_id(__FILE__, __LINE__, fmt, _cw_types); \
+            static constexpr auto _cw_fmt = cloakwork::logging::detail::seal(fmt, _cw_id); \
+            constinit static cloakwork::logging::detail::site _cw_site = { \
+                nullptr, _cw_id, _cw_fmt.data(), static_cast<uint32_t>(_cw_fmt.size()), \
+                static_cast<uint8_t>(cloakwork::logging::level::lvl), CW_ENABLE_STRING_ENCRYPTION, \
+                static_cast<uint8_t>(sizeof...(_cw_a)), _cw_types, 0 }; \
+            cloakwork::logging::detail::write(_cw_site, _cw_a...); \
+        } \
+    }(__VA_ARGS__)
+#endif
+
 #if CW_ENABLE_VALUE_OBFUSCATION
 
 #if CW_KERNEL_MODE
@@ -3800,7 +7175,7 @@ namespace cloakwork {
 
 #if defined(_WIN32)
             // rdtsc XOR with stack: (x | ~x) is always all-ones
-            uint64_t tsc = __rdtsc();
+            uint64_t tsc = intrin::rdtsc();
             CW_COMPILER_BARRIER();
             uint64_t mixed = tsc ^ sp;
             volatile uint64_t check = mixed | ~mixed;
@@ -4025,7 +7400,7 @@ namespace cloakwork {
             // n*(n+1) must be even because one of {n, n+1} is always even.
             //
             static CW_NOINLINE bool consecutive_product_true() {
-                volatile uint32_t n = static_cast<uint32_t>(__rdtsc() & 0xFFFF);
+                volatile uint32_t n = static_cast<uint32_t>(intrin::rdtsc() & 0xFFFF);
                 CW_COMPILER_BARRIER();
                 uint32_t val = n;
                 volatile uint32_t product = val * (val + 1u);
@@ -4064,29 +7439,30 @@ namespace cloakwork {
             // is always the bitwidth. uses the hardware POPCNT instruction.
             //
             static CW_NOINLINE bool popcount_complement_true() {
-                volatile uint32_t x = static_cast<uint32_t>(__rdtsc());
+                volatile uint32_t x = static_cast<uint32_t>(intrin::rdtsc());
                 CW_COMPILER_BARRIER();
                 uint32_t val = x;
-                volatile uint32_t pc1 = __popcnt(val);
-                volatile uint32_t pc2 = __popcnt(~val);
+                volatile uint32_t pc1 = intrin::popcnt32(val);
+                volatile uint32_t pc2 = intrin::popcnt32(~val);
                 CW_COMPILER_BARRIER();
                 return (pc1 + pc2) == 32u;
             }
 
             //
             // Predicate 4: CRC32 of the same value computed through separate
-            // volatile paths always produces equal results. the _mm_crc32_u32
-            // intrinsic is a hardware instruction the decompiler shows as a
-            // real computation, not a foldable identity.
+            // volatile paths always produces equal results. the crc32
+            // instruction (sse4.2, software crc32c without it) is a hardware
+            // instruction the decompiler shows as a real computation, not a
+            // foldable identity.
             //
             static CW_NOINLINE bool crc_self_true() {
                 volatile uint32_t val = static_cast<uint32_t>(
                     reinterpret_cast<uintptr_t>(&val));
                 CW_COMPILER_BARRIER();
                 uint32_t v = val;
-                volatile uint32_t c1 = _mm_crc32_u32(0, v);
+                volatile uint32_t c1 = intrin::crc32c_u32(0, v);
                 CW_COMPILER_BARRIER();
-                volatile uint32_t c2 = _mm_crc32_u32(0, v);
+                volatile uint32_t c2 = intrin::crc32c_u32(0, v);
                 CW_COMPILER_BARRIER();
                 return c1 == c2;
             }
@@ -4100,7 +7476,7 @@ namespace cloakwork {
             static CW_NOINLINE bool bezout_true() {
                 volatile uint32_t a = static_cast<uint32_t>(
                     reinterpret_cast<uintptr_t>(&a)) | 1u;
-                volatile uint32_t b = static_cast<uint32_t>(__rdtsc()) | 1u;
+                volatile uint32_t b = static_cast<uint32_t>(intrin::rdtsc()) | 1u;
                 CW_COMPILER_BARRIER();
                 uint32_t va = a, vb = b;
                 // Euclidean GCD
@@ -4122,13 +7498,12 @@ namespace cloakwork {
             // instructions the decompiler can't fold.
             //
             static CW_NOINLINE bool bit_decompose_true() {
-                volatile uint32_t x = static_cast<uint32_t>(__rdtsc()) | 1u;
+                volatile uint32_t x = static_cast<uint32_t>(intrin::rdtsc()) | 1u;
                 CW_COMPILER_BARRIER();
                 uint32_t v = x;
-                unsigned long bsf_idx, bsr_idx;
-                _BitScanForward(&bsf_idx, v);
-                _BitScanReverse(&bsr_idx, v);
-                volatile uint32_t pc = __popcnt(v);
+                uint32_t bsf_idx = intrin::bsf32(v);
+                uint32_t bsr_idx = intrin::bsr32(v);
+                volatile uint32_t pc = intrin::popcnt32(v);
                 CW_COMPILER_BARRIER();
                 uint32_t leading  = 31u - bsr_idx;
                 uint32_t trailing = bsf_idx;
@@ -4143,7 +7518,7 @@ namespace cloakwork {
             // 32-bit integers. the resulting code looks like real crypto work.
             //
             static CW_NOINLINE bool modinv_true() {
-                volatile uint32_t x = (static_cast<uint32_t>(__rdtsc()) | 1u);
+                volatile uint32_t x = (static_cast<uint32_t>(intrin::rdtsc()) | 1u);
                 CW_COMPILER_BARRIER();
                 uint32_t v = x;
                 // Newton's method for modular inverse:
@@ -5255,35 +8630,97 @@ namespace cloakwork {
     namespace imports {
 
         namespace detail {
-            // validate PE header structure with bounds checking
-            CW_FORCEINLINE bool validate_pe_header(void* module, IMAGE_NT_HEADERS** out_nt, uint32_t* out_image_size) {
-                auto dos = static_cast<IMAGE_DOS_HEADER*>(module);
-                if (dos->e_magic != IMAGE_DOS_SIGNATURE) return false;
+#if !CW_KERNEL_MODE
+            //
+            // per-module export hash indexes for the resolver. each one is built on
+            // the first lookup in that module and reused until a different image
+            // shows up at the same base (checked through the export directory's
+            // timestamp and name count). building happens outside the lock so a
+            // fault while reading a module can't leave the lock held. the cache is
+            // created on first use and never freed, so there is no static
+            // destructor to race a late lookup from another thread or an atexit
+            // handler.
+            //
+            struct indexed_module {
+                const void* base = nullptr;
+                uint32_t stamp = 0;
+                pe::export_index index;
+            };
 
-                // e_lfanew must be positive and within reasonable bounds
-                if (dos->e_lfanew <= 0 || dos->e_lfanew >= 0x1000) return false;
+            struct export_index_cache {
+                CW_MUTEX lock;
+                indexed_module slots[CW_EXPORT_INDEX_SLOTS];
+                size_t next = 0;
+            };
 
-                auto nt = reinterpret_cast<IMAGE_NT_HEADERS*>(
-                    reinterpret_cast<uint8_t*>(module) + dos->e_lfanew);
+            // null if the allocation failed; callers then scan the exports
+            inline export_index_cache* index_cache() {
+                static export_index_cache* const cache = new (std::nothrow) export_index_cache;
+                return cache;
+            }
 
-#if CW_KERNEL_MODE
-                if (!MmIsAddressValid(nt)) return false;
-#endif
-                if (nt->Signature != IMAGE_NT_SIGNATURE) return false;
+            inline uint32_t export_stamp(const pe::image_view& img) {
+                const uint8_t* dir = img.at(img.export_rva(), pe::detail::export_directory_size);
+                if (!dir) return 0;
+                return pe::detail::read<uint32_t>(dir + 4) ^ pe::detail::read<uint32_t>(dir + 24) ^ img.image_size();
+            }
 
-                uint32_t image_size = nt->OptionalHeader.SizeOfImage;
-                if (image_size == 0 || image_size > 0x7FFFFFFF) return false;
+            // looks func_hash up in the module's index and stores the export RVA
+            // (0 if not exported) in rva. false if no index could be built
+            inline bool indexed_export(const pe::image_view& img, uint32_t func_hash, uint32_t& rva) {
+                export_index_cache* cache = index_cache();
+                if (!cache) return false;
+                uint32_t stamp = export_stamp(img);
+                {
+                    CW_LOCK_GUARD(cache->lock);
+                    for (auto& m : cache->slots) {
+                        if (m.base == img.data() && m.stamp == stamp) {
+                            rva = m.index.find(func_hash);
+                            return true;
+                        }
+                    }
+                }
 
-                *out_nt = nt;
-                *out_image_size = image_size;
+                pe::export_index built;
+                if (!built.build(img)) return false;
+                rva = built.find(func_hash);
+
+                CW_LOCK_GUARD(cache->lock);
+                indexed_module* slot = nullptr;
+                for (auto& m : cache->slots)
+                    if (m.base == img.data()) slot = &m;
+                if (!slot) slot = &cache->slots[cache->next++ % CW_EXPORT_INDEX_SLOTS];
+                slot->base = img.data();
+                slot->stamp = stamp;
+                slot->index = std::move(built);
                 return true;
             }
-
-            // validate that an RVA falls within image bounds
-            CW_FORCEINLINE bool rva_in_bounds(uint32_t rva, uint32_t size, uint32_t image_size) {
-                uint64_t end = static_cast<uint64_t>(rva) + static_cast<uint64_t>(size);
-                return rva < image_size && end <= static_cast<uint64_t>(image_size);
+#else
+            //
+            // image_view bounds-checks every read against the image, but in kernel
+            // mode an in-bounds page can still be paged out, and touching it at
+            // raised IRQL bugchecks. these probe each structure before it is read.
+            //
+            inline bool parse_resident(pe::image_view& img, void* base) {
+                auto p = static_cast<uint8_t*>(base);
+                if (!MmIsAddressValid(p)) return false;
+                uint32_t nt = pe::detail::read<uint32_t>(p + 0x3C);
+                if (nt == 0 || nt >= 0x1000 || !MmIsAddressValid(p + nt)) return false;
+                return img.parse_module(base);
+            }
+
+            // the export directory, then the name, ordinal and function tables
+            inline bool exports_resident(const pe::image_view& img) {
+                const uint8_t* dir = img.at(img.export_rva(), pe::detail::export_directory_size);
+                if (!dir || !MmIsAddressValid(const_cast<uint8_t*>(dir))) return false;
+                const uint32_t tables[] = { 28, 32, 36 };
+                for (uint32_t at : tables) {
+                    const uint8_t* table = img.at(pe::detail::read<uint32_t>(dir + at), 1);
+                    if (!table || !MmIsAddressValid(const_cast<uint8_t*>(table))) return false;
+                }
+                return true;
             }
+#endif
 
             // parse "DllName.FunctionName" forwarded export string and resolve recursively
             CW_FORCEINLINE void* resolve_forwarded_export(const char* forward_str) {
@@ -5331,7 +8768,7 @@ namespace cloakwork {
                 for (auto curr = head->Flink; curr != head; curr = curr->Flink) {
                     auto entry = CONTAINING_RECORD(curr, cloakwork_internal::CW_LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
                     if (!entry->BaseDllName.Buffer || entry->BaseDllName.Length == 0) continue;
-                    if (hash::fnv1a_runtime_ci_w2a(entry->BaseDllName.Buffer) == mod_hash) {
+                    if (hash::fnv1a_runtime_ci_w2a(entry->BaseDllName) == mod_hash) {
                         target_mod = entry->DllBase;
                         break;
                     }
@@ -5339,39 +8776,16 @@ namespace cloakwork {
 #endif
                 if (!target_mod) return nullptr;
 
-                // now resolve the function in the target module (non-recursive getProcAddress inline)
-                IMAGE_NT_HEADERS* nt = nullptr;
-                uint32_t image_size = 0;
-                if (!validate_pe_header(target_mod, &nt, &image_size)) return nullptr;
-
-                auto& exp_dir = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
-                if (exp_dir.VirtualAddress == 0) return nullptr;
-                if (!rva_in_bounds(exp_dir.VirtualAddress, exp_dir.Size, image_size)) return nullptr;
-
-                auto exports = reinterpret_cast<IMAGE_EXPORT_DIRECTORY*>(
-                    reinterpret_cast<uint8_t*>(target_mod) + exp_dir.VirtualAddress);
-
-                if (!rva_in_bounds(exports->AddressOfNames, exports->NumberOfNames * 4, image_size)) return nullptr;
-                if (!rva_in_bounds(exports->AddressOfNameOrdinals, exports->NumberOfNames * 2, image_size)) return nullptr;
-                if (!rva_in_bounds(exports->AddressOfFunctions, exports->NumberOfFunctions * 4, image_size)) return nullptr;
-
-                auto names = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(target_mod) + exports->AddressOfNames);
-                auto ordinals = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(target_mod) + exports->AddressOfNameOrdinals);
-                auto functions = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(target_mod) + exports->AddressOfFunctions);
-
-                for (uint32_t i = 0; i < exports->NumberOfNames; ++i) {
-                    if (!rva_in_bounds(names[i], 1, image_size)) continue;
-                    auto name = reinterpret_cast<const char*>(reinterpret_cast<uint8_t*>(target_mod) + names[i]);
-                    if (hash::fnv1a_runtime(name) == func_hash) {
-                        uint16_t ordinal = ordinals[i];
-                        if (ordinal >= exports->NumberOfFunctions) return nullptr;
-                        uint32_t func_rva = functions[ordinal];
-                        // don't follow another forward - one level is enough
-                        return reinterpret_cast<uint8_t*>(target_mod) + func_rva;
-                    }
-                }
+                // don't follow another forward - one level is enough
+                pe::image_view img;
+                if (!img.parse_module(target_mod)) return nullptr;
 
-                return nullptr;
+                uint32_t rva = 0;
+#if !CW_KERNEL_MODE
+                if (!indexed_export(img, func_hash, rva))
+#endif
+                    rva = pe::find_export(img, func_hash);
+                return rva ? reinterpret_cast<uint8_t*>(target_mod) + rva : nullptr;
             }
         }
 
@@ -5396,9 +8810,8 @@ namespace cloakwork {
                 RtlPcToFileHeader(reinterpret_cast<PVOID>(RtlPcToFileHeader), &ntoskrnl_base);
 
                 if (ntoskrnl_base) {
-                    IMAGE_NT_HEADERS* nt = nullptr;
-                    uint32_t image_size = 0;
-                    if (detail::validate_pe_header(ntoskrnl_base, &nt, &image_size)) {
+                    pe::image_view img;
+                    if (detail::parse_resident(img, ntoskrnl_base)) {
                         uint32_t ntoskrnl_hashes[] = {
                             hash::fnv1a_ci("ntoskrnl.exe", 12),
                             hash::fnv1a_ci("ntkrnlpa.exe", 12),
@@ -5438,7 +8851,7 @@ namespace cloakwork {
                     if (!entry->BaseDllName.Buffer || entry->BaseDllName.Length == 0) continue;
                     if (!MmIsAddressValid(entry->BaseDllName.Buffer)) continue;
 
-                    uint32_t modHash = hash::fnv1a_runtime_ci_w2a(entry->BaseDllName.Buffer);
+                    uint32_t modHash = hash::fnv1a_runtime_ci_w2a(entry->BaseDllName);
                     if (modHash == moduleHash) {
                         return entry->DllBase;
                     }
@@ -5463,7 +8876,7 @@ namespace cloakwork {
                     auto entry = CONTAINING_RECORD(curr, cloakwork_internal::CW_LDR_DATA_TABLE_ENTRY, InMemoryOrderLinks);
                     if (!entry->BaseDllName.Buffer || entry->BaseDllName.Length == 0) continue;
 
-                    uint32_t modHash = hash::fnv1a_runtime_ci_w2a(entry->BaseDllName.Buffer);
+                    uint32_t modHash = hash::fnv1a_runtime_ci_w2a(entry->BaseDllName);
                     if (modHash == moduleHash) {
                         return entry->DllBase;
                     }
@@ -5477,74 +8890,50 @@ namespace cloakwork {
         }
 
         CW_FORCEINLINE void* walkExportTable(void* module, uint32_t funcHash) {
-            IMAGE_NT_HEADERS* nt = nullptr;
-            uint32_t image_size = 0;
-            if (!detail::validate_pe_header(module, &nt, &image_size)) return nullptr;
-
-            auto& export_entry = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT];
-            if (export_entry.VirtualAddress == 0 || export_entry.Size == 0) return nullptr;
-
-            // validate export directory RVA + size within image bounds
-            if (!detail::rva_in_bounds(export_entry.VirtualAddress, export_entry.Size, image_size))
-                return nullptr;
-
-            auto base = reinterpret_cast<uint8_t*>(module);
-            auto exports = reinterpret_cast<IMAGE_EXPORT_DIRECTORY*>(base + export_entry.VirtualAddress);
-
+            pe::image_view img;
 #if CW_KERNEL_MODE
-            if (!MmIsAddressValid(exports)) return nullptr;
+            if (!detail::parse_resident(img, module)) return nullptr;
+#else
+            if (!img.parse_module(module)) return nullptr;
 #endif
+            auto base = reinterpret_cast<uint8_t*>(module);
 
-            // validate all three table RVAs
-            if (!detail::rva_in_bounds(exports->AddressOfNames,
-                exports->NumberOfNames * sizeof(uint32_t), image_size))
-                return nullptr;
-            if (!detail::rva_in_bounds(exports->AddressOfNameOrdinals,
-                exports->NumberOfNames * sizeof(uint16_t), image_size))
-                return nullptr;
-            if (!detail::rva_in_bounds(exports->AddressOfFunctions,
-                exports->NumberOfFunctions * sizeof(uint32_t), image_size))
-                return nullptr;
-
-            auto names = reinterpret_cast<uint32_t*>(base + exports->AddressOfNames);
-            auto ordinals = reinterpret_cast<uint16_t*>(base + exports->AddressOfNameOrdinals);
-            auto functions = reinterpret_cast<uint32_t*>(base + exports->AddressOfFunctions);
-
-            for (uint32_t i = 0; i < exports->NumberOfNames; ++i) {
-                if (!detail::rva_in_bounds(names[i], 1, image_size)) continue;
-
-                auto name = reinterpret_cast<const char*>(base + names[i]);
+            uint32_t rva = 0;
+#if !CW_KERNEL_MODE
+            // O(1) through the module's export index; the scan below is the
+            // fallback when the index can't be built
+            if (!detail::indexed_export(img, funcHash, rva))
+#endif
+            {
 #if CW_KERNEL_MODE
-                if (!MmIsAddressValid(const_cast<char*>(name))) continue;
+                // probed before export_range reads the directory and its tables
+                if (!detail::exports_resident(img)) return nullptr;
 #endif
-
-                if (hash::fnv1a_runtime(name) == funcHash) {
-                    // bounds-check ordinal before using as index into functions array
-                    uint16_t ordinal = ordinals[i];
-                    if (ordinal >= exports->NumberOfFunctions) return nullptr;
-
-                    uint32_t func_rva = functions[ordinal];
-
-                    // check for forwarded export using 64-bit arithmetic to prevent overflow
-                    uint64_t export_start = static_cast<uint64_t>(export_entry.VirtualAddress);
-                    uint64_t export_end = export_start + static_cast<uint64_t>(export_entry.Size);
-
-                    if (static_cast<uint64_t>(func_rva) >= export_start &&
-                        static_cast<uint64_t>(func_rva) < export_end) {
+                pe::export_range exports = img.exports();
+                for (uint32_t i = 0; i < exports.size(); ++i) {
+                    size_t max;
+                    const char* name = exports.name(i, max);
+                    if (!name) continue;
 #if CW_KERNEL_MODE
-                        // kernel mode: don't follow forwarded exports
-                        return nullptr;
-#else
-                        auto forward_str = reinterpret_cast<const char*>(base + func_rva);
-                        return detail::resolve_forwarded_export(forward_str);
+                    if (!MmIsAddressValid(const_cast<char*>(name))) continue;
 #endif
+                    if (hash::fnv1a_runtime_bounded(name, max) == funcHash) {
+                        rva = exports[i].rva;
+                        break;
                     }
-
-                    return base + func_rva;
                 }
             }
+            if (!rva) return nullptr;
 
-            return nullptr;
+            if (img.in_export_directory(rva)) {
+#if CW_KERNEL_MODE
+                // kernel mode: don't follow forwarded exports
+                return nullptr;
+#else
+                return detail::resolve_forwarded_export(reinterpret_cast<const char*>(base + rva));
+#endif
+            }
+            return base + rva;
         }
 
         CW_FORCEINLINE void* getProcAddress(void* module, uint32_t funcHash) {
@@ -5565,9 +8954,14 @@ namespace cloakwork {
 #endif
         }
 
+        // one resolved address per (module, function), shared by every CW_IMPORT
+        // site naming that pair and filled in bulk by CW_IMPORT_SET
+        template<uint32_t ModuleHash, uint32_t FuncHash>
+        inline CW_ATOMIC(uintptr_t) import_slot{0};
+
         template<uint32_t ModuleHash, uint32_t FuncHash>
         CW_FORCEINLINE void* getCachedImport() {
-            static CW_ATOMIC(uintptr_t) cached{0};
+            auto& cached = import_slot<ModuleHash, FuncHash>;
             uintptr_t val = cached.load(CW_MO_ACQUIRE);
             if (!val) {
                 void* mod = getModuleBase(ModuleHash);
@@ -5578,8 +8972,71 @@ namespace cloakwork {
             }
             return reinterpret_cast<void*>(val);
         }
+
+        namespace detail {
+            // unevaluated; fails to compile if a CW_IMPORT_SET name isn't a declared function
+            template<typename... Fs>
+            char names_exist(Fs*...);
+
+            template<size_t N>
+            CW_FORCEINLINE size_t scan_import_set(void* module, const hash::hash_map<uint16_t, N>& wanted,
+                                                  uint32_t (&rvas)[N], pe::image_view& img) {
+                CW_SEH_TRY {
+                    if (!img.parse_module(module)) return 0;
+                    return pe::resolve_exports(img, wanted, rvas);
+                }
+                CW_SEH_EXCEPT {
+                    return 0;
+                }
+            }
+
+            template<uint32_t ModuleHash, auto Names, size_t I = 0>
+            CW_FORCEINLINE void store_import_slots(const uintptr_t* addrs) {
+                if constexpr (I < sizeof(Names.hashes) / sizeof(uint32_t)) {
+                    if (addrs[I]) import_slot<ModuleHash, Names.hashes[I]>.store(addrs[I], CW_MO_RELEASE);
+                    store_import_slots<ModuleHash, Names, I + 1>(addrs);
+                }
+            }
+        }
+
+        // resolves every name in Names from one module with a single PEB walk and
+        // a single export scan, and fills the CW_IMPORT cache for each. returns how
+        // many were resolved
+        template<uint32_t ModuleHash, auto Names>
+        inline size_t resolveImportSet() {
+            constexpr size_t N = sizeof(Names.hashes) / sizeof(uint32_t);
+            static constexpr auto wanted = pe::export_name_positions(Names);
+
+            void* mod = getModuleBase(ModuleHash);
+            if (!mod) return 0;
+
+            pe::image_view img;
+            uint32_t rvas[N];
+            if (!detail::scan_import_set(mod, wanted, rvas, img)) return 0;
+
+            auto base = reinterpret_cast<uint8_t*>(mod);
+            uintptr_t addrs[N]{};
+            size_t resolved = 0;
+            for (size_t i = 0; i < N; ++i) {
+                if (!rvas[i]) continue;
+                void* p = img.in_export_directory(rvas[i])
+                    ? detail::resolve_forwarded_export(reinterpret_cast<const char*>(base + rvas[i]))
+                    : base + rvas[i];
+                addrs[i] = reinterpret_cast<uintptr_t>(p);
+                if (p) ++resolved;
+            }
+            detail::store_import_slots<ModuleHash, Names>(addrs);
+            return resolved;
+        }
     }
 
+    // CW_IMPORT_SET("kernel32.dll", VirtualAlloc, VirtualFree, CreateFileW) resolves
+    // the whole set up front; later CW_IMPORT calls for those names are cache hits
+    #define CW_IMPORT_SET(mod, ...) \
+        (static_cast<void>(sizeof(cloakwork::imports::detail::names_exist(__VA_ARGS__))), \
+         cloakwork::imports::resolveImportSet<CW_HASH_CI(mod), \
+             cloakwork::pe::hash_export_names<cloakwork::pe::count_export_names(#__VA_ARGS__)>(#__VA_ARGS__)>())
+
     #define CW_IMPORT(mod, func) \
         reinterpret_cast<decltype(&func)>( \
             cloakwork::imports::getCachedImport<CW_HASH_CI(mod), CW_HASH(#func)>())
@@ -5591,9 +9048,17 @@ namespace cloakwork {
     namespace imports {
         inline void* getModuleBase(uint32_t) { return nullptr; }
         inline void* getProcAddress(void*, uint32_t) { return nullptr; }
+
+        namespace detail {
+            template<typename... Fs>
+            char names_exist(Fs*...);
+        }
     }
     #define CW_IMPORT(mod, func) (&func)
     #define CW_IMPORT_WIDE(mod, func) (&func)
+    #define CW_IMPORT_SET(mod, ...) \
+        (static_cast<void>(sizeof(cloakwork::imports::detail::names_exist(__VA_ARGS__))), \
+         cloakwork::pe::count_export_names(#__VA_ARGS__))
 #endif
 
 #if CW_ENABLE_SYSCALLS
@@ -5679,25 +9144,19 @@ namespace cloakwork {
                 void* ntdll = imports::getModuleBase(CW_HASH_CI("ntdll.dll"));
                 if (!ntdll) return nullptr;
 
-                IMAGE_NT_HEADERS* nt = nullptr;
-                uint32_t image_size = 0;
-                if (!imports::detail::validate_pe_header(ntdll, &nt, &image_size)) return nullptr;
-
-                auto base = reinterpret_cast<uint8_t*>(ntdll);
-
-                auto section = IMAGE_FIRST_SECTION(nt);
-                for (uint16_t i = 0; i < nt->FileHeader.NumberOfSections; ++i, ++section) {
-                    if (!(section->Characteristics & IMAGE_SCN_MEM_EXECUTE)) continue;
+                pe::image_view img;
+                if (!img.parse_module(ntdll)) return nullptr;
 
-                    uint32_t sec_start = section->VirtualAddress;
-                    uint32_t sec_size = section->Misc.VirtualSize;
-                    if (!imports::detail::rva_in_bounds(sec_start, sec_size, image_size)) continue;
+                for (const pe::section& sec : img.sections()) {
+                    if (!sec.executable()) continue;
+                    const uint8_t* text = img.at(sec.virtual_address, sec.virtual_size);
+                    if (!text) continue;
 
                     // scan for syscall; ret (0F 05 C3)
-                    for (uint32_t j = 0; j + 2 < sec_size; ++j) {
-                        uint8_t* p = base + sec_start + j;
+                    for (uint32_t j = 0; j + 2 < sec.virtual_size; ++j) {
+                        const uint8_t* p = text + j;
                         if (p[0] == 0x0F && p[1] == 0x05 && p[2] == 0xC3) {
-                            return p;
+                            return const_cast<uint8_t*>(p);
                         }
                     }
                 }
@@ -5996,21 +9455,17 @@ namespace cloakwork {
                 void* ntdll = imports::getModuleBase(CW_HASH_CI("ntdll.dll"));
                 if (!ntdll) return nullptr;
 
-                IMAGE_NT_HEADERS* nt = nullptr;
-                uint32_t image_size = 0;
-                if (!imports::detail::validate_pe_header(ntdll, &nt, &image_size)) return nullptr;
-
-                auto base = reinterpret_cast<uint8_t*>(ntdll);
-                auto section = IMAGE_FIRST_SECTION(nt);
-                for (uint16_t i = 0; i < nt->FileHeader.NumberOfSections; ++i, ++section) {
-                    if (!(section->Characteristics & IMAGE_SCN_MEM_EXECUTE)) continue;
-                    uint32_t sec_start = section->VirtualAddress;
-                    uint32_t sec_size = section->Misc.VirtualSize;
-                    if (!imports::detail::rva_in_bounds(sec_start, sec_size, image_size)) continue;
-
-                    for (uint32_t j = 0; j < sec_size; ++j) {
-                        if (base[sec_start + j] == 0xC3)
-                            return base + sec_start + j;
+                pe::image_view img;
+                if (!img.parse_module(ntdll)) return nullptr;
+
+                for (const pe::section& sec : img.sections()) {
+                    if (!sec.executable()) continue;
+                    const uint8_t* text = img.at(sec.virtual_address, sec.virtual_size);
+                    if (!text) continue;
+
+                    for (uint32_t j = 0; j < sec.virtual_size; ++j) {
+                        if (text[j] == 0xC3)
+                            return const_cast<uint8_t*>(text + j);
                     }
                 }
             }
@@ -6032,23 +9487,18 @@ namespace cloakwork {
                 void* ntdll = imports::getModuleBase(CW_HASH_CI("ntdll.dll"));
                 if (!ntdll) return nullptr;
 
-                IMAGE_NT_HEADERS* nt = nullptr;
-                uint32_t image_size = 0;
-                if (!imports::detail::validate_pe_header(ntdll, &nt, &image_size))
-                    return nullptr;
+                pe::image_view img;
+                if (!img.parse_module(ntdll)) return nullptr;
 
-                auto base = reinterpret_cast<uint8_t*>(ntdll);
-                auto section = IMAGE_FIRST_SECTION(nt);
-                for (uint16_t i = 0; i < nt->FileHeader.NumberOfSections; ++i, ++section) {
-                    if (!(section->Characteristics & IMAGE_SCN_MEM_EXECUTE)) continue;
-                    uint32_t start = section->VirtualAddress;
-                    uint32_t size = section->Misc.VirtualSize;
-                    if (!imports::detail::rva_in_bounds(start, size, image_size)) continue;
+                for (const pe::section& sec : img.sections()) {
+                    if (!sec.executable()) continue;
+                    const uint8_t* text = img.at(sec.virtual_address, sec.virtual_size);
+                    if (!text) continue;
 
-                    for (uint32_t j = 0; j + 1 < size; ++j) {
-                        uint8_t* p = base + start + j;
+                    for (uint32_t j = 0; j + 1 < sec.virtual_size; ++j) {
+                        const uint8_t* p = text + j;
                         if (p[0] == 0xFF && p[1] == 0xE3) // jmp rbx
-                            return p;
+                            return const_cast<uint8_t*>(p);
                     }
                 }
             }
@@ -6168,7 +9618,7 @@ namespace cloakwork {
 
                     if (currentHash != expectedHash) {
 #if CW_ANTI_DEBUG_RESPONSE == 1
-                        __debugbreak();
+                        intrin::debug_break();
                         *(volatile int*)0 = 0;
 #endif
                     }
@@ -6202,6 +9652,8 @@ namespace cloakwork {
 
             // check for int3 breakpoint
             if (bytes[0] == 0xCC) return true;
+#else
+            (void)func;
 #endif
             return false;
         }
@@ -6527,6 +9979,8 @@ namespace cloakwork {
 
     #define CW_HASH_RT(str)              (cloakwork::hash::fnv1a_runtime(str))
     #define CW_HASH_RT_CI(str)           (cloakwork::hash::fnv1a_runtime_ci(str))
+    #define CW_HASH64_RT(str)            (cloakwork::hash::hash64_runtime(str))
+    #define CW_HASH64_RT_CI(str)         (cloakwork::hash::hash64_runtime_ci(str))
 
 #if CW_ENABLE_INTEGRITY_CHECKS
     #define CW_COMPUTE_HASH(ptr, size)   (cloakwork::integrity::computeHash(ptr, size))
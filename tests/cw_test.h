@@ -0,0 +1,15 @@
+// minimal check macro shared by the tests. a failed check prints where and
+// exits non-zero, so ctest reports the case as failed.
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CW_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::_Exit(1); \
+        } \
+    } while (0)
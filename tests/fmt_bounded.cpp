@@ -0,0 +1,92 @@
+// the bounded iterator behind CW_FMT_TO_N, driven directly so it runs on any
+// toolchain: writes stop at n, the count keeps going, and nothing lands past
+// the bound. fmt_to.cpp covers the macros on top of it where <format> exists.
+
+#include "cloakwork.h"
+#include "cw_test.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+using cloakwork::fmt_detail::bounded_iterator;
+using cloakwork::fmt_detail::bounded_state;
+
+// what std::vformat_to needs from its output iterator
+static_assert(std::output_iterator<bounded_iterator<char*>, const char&>);
+static_assert(std::output_iterator<bounded_iterator<std::back_insert_iterator<std::string>>, const char&>);
+
+namespace {
+
+    constexpr std::string_view text = "id=7:ok";
+
+    struct buffer {
+        char data[16];
+        buffer() { memset(data, '#', sizeof(data)); }
+
+        bool holds(size_t len) const {
+            if (memcmp(data, text.data(), len) != 0) return false;
+            for (size_t i = len; i < sizeof(data); ++i)
+                if (data[i] != '#') return false;
+            return true;
+        }
+    };
+
+    // same clamp as vformat_to_n
+    bounded_state<char*> write_n(char* out, ptrdiff_t n) {
+        bounded_state<char*> state{ out, n > 0 ? n : 0 };
+        std::copy(text.begin(), text.end(), bounded_iterator<char*>{ &state });
+        return state;
+    }
+}
+
+int main() {
+    // n past the output length: everything written
+    {
+        buffer b;
+        auto r = write_n(b.data, sizeof(b.data));
+        CW_CHECK(r.out == b.data + text.size());
+        CW_CHECK(r.count == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(text.size()));
+    }
+
+    // n == output length: everything written, nothing past it
+    {
+        buffer b;
+        auto r = write_n(b.data, text.size());
+        CW_CHECK(r.out == b.data + text.size());
+        CW_CHECK(r.left == 0);
+        CW_CHECK(r.count == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(text.size()));
+    }
+
+    // n == output length - 1: the last char is dropped, count still has it
+    {
+        buffer b;
+        auto r = write_n(b.data, text.size() - 1);
+        CW_CHECK(r.out == b.data + text.size() - 1);
+        CW_CHECK(r.count == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(text.size() - 1));
+    }
+
+    // n <= 0 writes nothing
+    for (ptrdiff_t n : { ptrdiff_t(0), ptrdiff_t(-1) }) {
+        buffer b;
+        auto r = write_n(b.data, n);
+        CW_CHECK(r.out == b.data);
+        CW_CHECK(r.count == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(0));
+    }
+
+    // through a back inserter, with ranges::copy for the C++20 concept path
+    {
+        std::string line = "> ";
+        bounded_state<std::back_insert_iterator<std::string>> state{ std::back_inserter(line), 4 };
+        std::ranges::copy(text, bounded_iterator<std::back_insert_iterator<std::string>>{ &state });
+        CW_CHECK(line == "> id=7");
+        CW_CHECK(state.count == static_cast<ptrdiff_t>(text.size()));
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// CW_FMT_TO / CW_FMT_TO_N: output has to match std::format_to and
+// std::format_to_n, including truncation right at the bound. a sentinel after
+// the bound catches any write past n.
+//
+// the macros need <format> (gcc 13+, clang 17+ with libc++, msvc 19.29+).
+// without it they are not defined and the case reports itself as skipped.
+
+#include "cloakwork.h"
+#include "cw_test.h"
+
+#ifndef __cpp_lib_format
+
+int main() {
+    std::printf("skipped: needs <format>\n");
+    return 77;
+}
+
+#else
+
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace {
+
+    constexpr std::string_view text = "id=7:ok";
+
+    struct buffer {
+        char data[16];
+        buffer() { memset(data, '#', sizeof(data)); }
+
+        // the first len chars match text and the rest is untouched
+        bool holds(size_t len) const {
+            if (memcmp(data, text.data(), len) != 0) return false;
+            for (size_t i = len; i < sizeof(data); ++i)
+                if (data[i] != '#') return false;
+            return true;
+        }
+    };
+
+    auto format_n(char* out, ptrdiff_t n) { return CW_FMT_TO_N(out, n, "id={}:{}", 7, "ok"); }
+}
+
+int main() {
+    // unbounded, into a buffer and through a back inserter
+    {
+        buffer b;
+        char* end = CW_FMT_TO(b.data, "id={}:{}", 7, "ok");
+        CW_CHECK(end == b.data + text.size());
+        CW_CHECK(b.holds(text.size()));
+
+        std::string line = "> ";
+        CW_FMT_TO(std::back_inserter(line), "id={}:{}", 7, std::string_view("ok"));
+        CW_CHECK(line == "> id=7:ok");
+    }
+
+    // n == output length: everything written, nothing past it
+    {
+        buffer b;
+        auto r = format_n(b.data, text.size());
+        CW_CHECK(r.out == b.data + text.size());
+        CW_CHECK(r.size == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(text.size()));
+    }
+
+    // n == output length - 1: the last char is dropped, size still counts it
+    {
+        buffer b;
+        auto r = format_n(b.data, text.size() - 1);
+        CW_CHECK(r.out == b.data + text.size() - 1);
+        CW_CHECK(r.size == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(text.size() - 1));
+    }
+
+    // n <= 0 writes nothing, like std::format_to_n
+    for (ptrdiff_t n : { ptrdiff_t(0), ptrdiff_t(-1) }) {
+        buffer b;
+        auto r = format_n(b.data, n);
+        CW_CHECK(r.out == b.data);
+        CW_CHECK(r.size == static_cast<ptrdiff_t>(text.size()));
+        CW_CHECK(b.holds(0));
+    }
+
+    // same results as the standard library
+    {
+        buffer ours, theirs;
+        auto a = format_n(ours.data, 4);
+        auto b = std::format_to_n(theirs.data, 4, "id={}:{}", 7, "ok");
+        CW_CHECK(a.size == b.size);
+        CW_CHECK(a.out - ours.data == b.out - theirs.data);
+        CW_CHECK(memcmp(ours.data, theirs.data, sizeof(ours.data)) == 0);
+    }
+    return 0;
+}
+
+#endif
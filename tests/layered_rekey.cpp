@@ -0,0 +1,150 @@
+// layered string re-keying: once a re-key publishes the other slot and the
+// last reader of the retired one moves on, the retired slot must be zero.
+// a slot another thread still holds must stay intact until that thread
+// calls get() again. a reader that drops the retired slot while a re-key holds
+// the lock leaves the wipe to that re-key.
+
+#include "cloakwork.h"
+#include "cw_test.h"
+
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    constexpr std::string_view text = "layered: rotating secret";
+
+    bool zeroed(const char* p) {
+        for (size_t i = 0; i < text.size() + 1; ++i)
+            if (p[i] != 0) return false;
+        return true;
+    }
+
+    // re-keys on every second read of a thread
+    const char* every_second() { return CW_STR_LAYERED_N("layered: rotating secret", 2); }
+
+    // re-keys on every read
+    const char* every_read() { return CW_STR_LAYERED_N("layered: rotating secret", 1); }
+
+    // never re-keys
+    const char* never() { return CW_STR_LAYERED_N("layered: rotating secret", 0); }
+
+    // a string of its own type (so its own per-thread hold), re-keyed on every read
+    using racy_string = cloakwork::string_encrypt::layered_encrypted_string<
+        sizeof("layered: rotating secret"), 0x1234567u, 0x89ABCDEu, 0x7654321u, 0xFEDCBA9u, 1>;
+    racy_string racy("layered: rotating secret");
+
+    // the re-key lock and unlock() are private; an explicit instantiation may
+    // name them, and the friend it defines hands the member pointers out
+    template<typename Tag, typename Tag::type M>
+    struct expose {
+        friend typename Tag::type member(Tag) { return M; }
+    };
+
+    struct lock_tag {
+        using type = std::atomic<uint32_t> racy_string::*;
+        friend type member(lock_tag);
+    };
+
+    struct unlock_tag {
+        using type = void (racy_string::*)() const;
+        friend type member(unlock_tag);
+    };
+
+    template struct expose<lock_tag, &racy_string::rekeying>;
+    template struct expose<unlock_tag, &racy_string::unlock>;
+}
+
+int main() {
+    // one thread: read 2 re-keys and moves this thread to the new slot, which
+    // drops the last hold on the old one
+    const char* first = every_second();
+    CW_CHECK(std::string_view(first) == text);
+    const char* second = every_second();
+    CW_CHECK(second != first);
+    CW_CHECK(std::string_view(second) == text);
+    CW_CHECK(zeroed(first));
+
+    // the slots alternate, and each retired one is wiped again
+    every_second();
+    const char* fourth = every_second();
+    CW_CHECK(fourth == first);
+    CW_CHECK(std::string_view(fourth) == text);
+    CW_CHECK(zeroed(second));
+
+    // another thread holding a slot keeps it intact and blocks its reuse
+    const char* held = every_read();
+    CW_CHECK(std::string_view(held) == text);
+    std::atomic<int> step{0};
+    const char* theirs = nullptr;
+    std::thread other([&] {
+        const char* mine = theirs = every_read();
+        step = 1;
+        while (step != 2) std::this_thread::yield();
+        // the main thread has moved on; this thread still holds its slot
+        CW_CHECK(std::string_view(mine) == text);
+        every_read();
+        every_read();
+    });
+    while (step != 1) std::this_thread::yield();
+    for (int i = 0; i < 8; ++i) CW_CHECK(std::string_view(every_read()) == text);
+    step = 2;
+    other.join();
+    CW_CHECK(theirs != held);
+    // the other thread released its hold on exit, so only the slot handed out
+    // now still holds plaintext
+    const char* now = every_read();
+    CW_CHECK(std::string_view(now) == text);
+    CW_CHECK(zeroed(now == held ? theirs : held));
+
+    // without re-keying there is one slot, handed out every time
+    const char* fixed = never();
+    CW_CHECK(never() == fixed);
+    CW_CHECK(std::string_view(fixed) == text);
+
+    // the last reader of the retired slot lets go while a re-key holds the lock
+    // (between its reader check and its unlock). it can't wipe, so the unlock
+    // has to
+    {
+        racy.get();
+        std::atomic<int> stage{0};
+        const char* retired = nullptr;
+        std::thread last([&] {
+            retired = racy.get();
+            stage = 1;
+            while (stage != 2) std::this_thread::yield();
+        });
+        while (stage != 1) std::this_thread::yield();
+        // moves main onto the other thread's slot, then re-keys away from it:
+        // now only the other thread holds the retired slot
+        racy.get();
+        const char* live = racy.get();
+        CW_CHECK(live != retired);
+
+        auto& lock = racy.*member(lock_tag{});
+        CW_CHECK(lock.exchange(1) == 0);
+        stage = 2;
+        last.join();
+        // the reader left without wiping, the lock was taken
+        CW_CHECK(std::string_view(retired) == text);
+        (racy.*member(unlock_tag{}))();
+        CW_CHECK(zeroed(retired));
+        CW_CHECK(std::string_view(live) == text);
+    }
+
+    // readers racing re-keys only ever see the plaintext in the slot they hold
+    std::atomic<bool> bad{false};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < 4; ++t) {
+        pool.emplace_back([&] {
+            for (int i = 0; i < 20000; ++i)
+                if (std::string_view(every_read()) != text) bad = true;
+        });
+    }
+    for (auto& t : pool) t.join();
+    CW_CHECK(!bad);
+    return 0;
+}
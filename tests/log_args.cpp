@@ -0,0 +1,23 @@
+// CW_LOG argument encoding, checked end to end through drain() and decode():
+// a nullptr argument logs like a null const char*.
+
+#define CW_LOG_DECODER
+#include "cloakwork.h"
+#include "cw_test.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+int main() {
+    const char* missing = nullptr;
+    CW_LOG(info, "user {} host {} id {}", nullptr, missing, 42);
+
+    std::vector<uint8_t> stream;
+    cloakwork::logging::drain([&](const uint8_t* p, size_t n) { stream.insert(stream.end(), p, p + n); });
+    std::vector<std::string> lines = cloakwork::logging::decode(stream.data(), stream.size(), CW_LOG_KEY);
+
+    CW_CHECK(lines.size() == 1);
+    CW_CHECK(lines[0].ends_with("user (null) host (null) id 42"));
+    return 0;
+}
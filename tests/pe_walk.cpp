@@ -0,0 +1,512 @@
+// before/after checks for the PE walks that moved onto pe::image_view. each
+// call site's earlier logic is kept here as a reference, reading raw offsets
+// the way the x64 windows build read IMAGE_* structures, and runs next to the
+// pe:: primitives the site calls now. the sites themselves only build on
+// windows; what is compared here is everything they do short of the PEB walk
+// and the final pointer arithmetic.
+//
+// the images are PE32+ in mapped layout, one well-formed and a set of damaged
+// variants. the few places where old and new are meant to disagree are listed
+// in `differences` with the reason.
+
+#include "cloakwork.h"
+#include "cw_test.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pe = cloakwork::pe;
+namespace hash = cloakwork::hash;
+
+namespace {
+
+    // layout of the test image
+    constexpr uint32_t nt = 0x80;
+    constexpr uint32_t opt = nt + 24;
+    constexpr uint16_t opt_size = 240;
+    constexpr uint32_t section_table = opt + opt_size;
+    constexpr uint32_t text_va = 0x1000, text_size = 0x200;
+    constexpr uint32_t data_va = 0x2000, data_size = 0x100;
+    constexpr uint32_t edata_va = 0x3000;
+    constexpr uint32_t image_size = 0x4000;
+    // old code read without bounds and relied on SEH; zeroed slack past the
+    // image keeps its out-of-image reads defined here
+    constexpr size_t slack = 0x10000;
+
+    constexpr uint32_t scn_exec = 0x60000020, scn_data = 0xC0000040;
+
+    // export directory fields, as offsets into .edata
+    constexpr uint32_t dir_functions = 40;
+    constexpr uint32_t function_count = 5;
+    constexpr uint32_t dir_names = dir_functions + function_count * 4;
+
+    void put16(std::vector<uint8_t>& b, size_t at, uint16_t v) { memcpy(&b[at], &v, 2); }
+    void put32(std::vector<uint8_t>& b, size_t at, uint32_t v) { memcpy(&b[at], &v, 4); }
+
+    template<typename T>
+    T get(const uint8_t* p) {
+        T v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    struct named_export {
+        const char* name;
+        uint32_t ordinal;
+    };
+
+    // function table: two code exports, a forwarder, a duplicate target, one spare
+    const named_export exports[] = {
+        { "NtClose", 0 },
+        { "NtOpenFile", 1 },
+        { "RtlForwarded", 2 },
+        { "BadOrdinal", 9 },   // past the function table
+        { "NtClose", 3 },      // duplicate name: the first one wins
+        { "NtQueryObject", 4 },
+    };
+    constexpr uint32_t name_count = sizeof(exports) / sizeof(exports[0]);
+    constexpr uint32_t dir_ordinals = dir_names + name_count * 4;
+
+    const char* const probes[] = {
+        "NtClose", "NtOpenFile", "RtlForwarded", "BadOrdinal", "NtQueryObject", "Missing", "",
+    };
+
+    std::vector<uint8_t> make_image() {
+        std::vector<uint8_t> b(image_size + slack, 0);
+        put16(b, 0, 0x5A4D);
+        put32(b, 0x3C, nt);
+        put32(b, nt, 0x4550);
+        put16(b, nt + 4, 0x8664);
+        put16(b, nt + 6, 3);
+        put16(b, nt + 20, opt_size);
+        put16(b, opt, 0x20B);
+        put32(b, opt + 56, image_size);
+        put32(b, opt + 60, 0x400);
+        put32(b, opt + 108, 16);
+
+        auto section = [&](int i, const char* name, uint32_t va, uint32_t size, uint32_t flags) {
+            uint32_t sh = section_table + i * 40;
+            memcpy(&b[sh], name, strlen(name));
+            put32(b, sh + 8, size);
+            put32(b, sh + 12, va);
+            put32(b, sh + 16, size);
+            put32(b, sh + 20, va);
+            put32(b, sh + 36, flags);
+        };
+        section(0, ".text", text_va, text_size, scn_exec);
+        section(1, ".data", data_va, data_size, scn_data);
+        section(2, ".edata", edata_va, image_size - edata_va, scn_data);
+
+        // code: padding, then jmp rbx, syscall; ret, and a plain ret
+        memset(&b[text_va], 0xCC, text_size);
+        const uint8_t code[] = { 0xFF, 0xE3, 0x90, 0x0F, 0x05, 0xC3, 0x90, 0xC3 };
+        memcpy(&b[text_va + 0x40], code, sizeof(code));
+        // the same bytes in a data section must never be picked
+        memcpy(&b[data_va], code, sizeof(code));
+
+        uint32_t strings = dir_ordinals + name_count * 2;
+        auto add_string = [&](const char* s) {
+            uint32_t rva = edata_va + strings;
+            memcpy(&b[rva], s, strlen(s) + 1);
+            strings += static_cast<uint32_t>(strlen(s)) + 1;
+            return rva;
+        };
+
+        uint32_t dir = edata_va;
+        put32(b, dir + 20, function_count);
+        put32(b, dir + 24, name_count);
+        put32(b, dir + 28, edata_va + dir_functions);
+        put32(b, dir + 32, edata_va + dir_names);
+        put32(b, dir + 36, edata_va + dir_ordinals);
+
+        put32(b, edata_va + dir_functions + 0, text_va + 0x10);
+        put32(b, edata_va + dir_functions + 4, text_va + 0x20);
+        put32(b, edata_va + dir_functions + 8, add_string("NTDLL.RtlInitUnicodeString"));
+        put32(b, edata_va + dir_functions + 12, text_va + 0x30);
+        put32(b, edata_va + dir_functions + 16, text_va + 0x48);
+
+        for (uint32_t i = 0; i < name_count; ++i) {
+            put32(b, edata_va + dir_names + i * 4, add_string(exports[i].name));
+            put16(b, edata_va + dir_ordinals + i * 2, static_cast<uint16_t>(exports[i].ordinal));
+        }
+
+        put32(b, opt + 112, edata_va);
+        put32(b, opt + 116, strings);
+        return b;
+    }
+
+    struct variant {
+        const char* name;
+        void (*damage)(std::vector<uint8_t>&);
+    };
+
+    const variant variants[] = {
+        { "well-formed", [](std::vector<uint8_t>&) {} },
+        { "export directory size 0", [](std::vector<uint8_t>& b) { put32(b, opt + 116, 0); } },
+        { "no export directory", [](std::vector<uint8_t>& b) { put32(b, opt + 112, 0); } },
+        { "no data directories", [](std::vector<uint8_t>& b) { put32(b, opt + 108, 0); } },
+        { "export directory past the image", [](std::vector<uint8_t>& b) { put32(b, opt + 112, image_size - 8); } },
+        { "name table past the image", [](std::vector<uint8_t>& b) { put32(b, edata_va + 32, image_size - 8); } },
+        { "function table past the image", [](std::vector<uint8_t>& b) { put32(b, edata_va + 28, image_size - 4); } },
+        { "name past the image", [](std::vector<uint8_t>& b) { put32(b, edata_va + dir_names + 4, image_size + 0x100); } },
+        { "zero function rva", [](std::vector<uint8_t>& b) { put32(b, edata_va + dir_functions + 4, 0); } },
+        { "unterminated name at the image end", [](std::vector<uint8_t>& b) {
+            memset(&b[image_size - 4], 'A', 4);
+            b[image_size] = 'B';
+            put32(b, edata_va + dir_names + 4, image_size - 4);
+        } },
+        { "text section past the image", [](std::vector<uint8_t>& b) { put32(b, section_table + 8, image_size); } },
+        { "text section not executable", [](std::vector<uint8_t>& b) { put32(b, section_table + 36, scn_data); } },
+        { "data section executable", [](std::vector<uint8_t>& b) { put32(b, section_table + 40 + 36, scn_exec); } },
+        { "bad dos magic", [](std::vector<uint8_t>& b) { put16(b, 0, 0x4D5A); } },
+        { "e_lfanew 0", [](std::vector<uint8_t>& b) { put32(b, 0x3C, 0); } },
+        { "e_lfanew 0x1000", [](std::vector<uint8_t>& b) {
+            // a plausible header just past the limit
+            memcpy(&b[0x1000], &b[nt], opt + opt_size - nt);
+            put32(b, 0x3C, 0x1000);
+        } },
+        { "bad nt signature", [](std::vector<uint8_t>& b) { put32(b, nt, 0x4551); } },
+        { "size of image 0", [](std::vector<uint8_t>& b) { put32(b, opt + 56, 0); } },
+        { "unknown optional header magic", [](std::vector<uint8_t>& b) { put16(b, opt, 0x1234); } },
+    };
+
+    enum check { header, walk, forward_tail, get_proc, import_set, export_index, scan_syscall, scan_ret, scan_jmp_rbx };
+
+    const char* const check_names[] = {
+        "header check (kernel ntoskrnl lookup)", "walkExportTable", "forwarded export tail",
+        "anti_debug get_proc_by_hash", "CW_IMPORT_SET resolve_exports", "export_index",
+        "syscall gadget scan", "ret gadget scan", "jmp rbx gadget scan",
+    };
+
+    // where old and new deliberately differ
+    struct difference {
+        const char* variant;
+        check site;
+        const char* reason;
+    };
+
+    const difference differences[] = {
+        // every path now reads the export directory the same way, as the index
+        // and CW_IMPORT_SET already did; the two scans used to require a size
+        { "export directory size 0", walk, "only the scans required a non-zero export directory size" },
+        { "export directory size 0", get_proc, "only the scans required a non-zero export directory size" },
+        // the old lookups read DataDirectory[0] without checking it exists
+        { "no data directories", walk, "NumberOfRvaAndSizes == 0 has no export directory" },
+        { "no data directories", forward_tail, "NumberOfRvaAndSizes == 0 has no export directory" },
+        { "no data directories", get_proc, "NumberOfRvaAndSizes == 0 has no export directory" },
+        // the old header check read the x64 layout whatever the magic said
+        { "unknown optional header magic", header, "neither PE32 nor PE32+" },
+        { "unknown optional header magic", walk, "neither PE32 nor PE32+" },
+        { "unknown optional header magic", forward_tail, "neither PE32 nor PE32+" },
+        { "unknown optional header magic", get_proc, "neither PE32 nor PE32+" },
+        { "unknown optional header magic", scan_syscall, "neither PE32 nor PE32+" },
+        { "unknown optional header magic", scan_ret, "neither PE32 nor PE32+" },
+        { "unknown optional header magic", scan_jmp_rbx, "neither PE32 nor PE32+" },
+        // get_proc_by_hash had no bounds checks at all, only SEH
+        { "function table past the image", get_proc, "unchecked reads past the image" },
+        { "name past the image", get_proc, "unchecked reads past the image" },
+        // a zero rva is "not exported"; the old scans returned the image base
+        { "zero function rva", walk, "rva 0 returned the module base" },
+        { "zero function rva", forward_tail, "rva 0 returned the module base" },
+        { "zero function rva", get_proc, "rva 0 returned the module base" },
+    };
+
+    constexpr size_t difference_count = sizeof(differences) / sizeof(differences[0]);
+    bool observed[difference_count];
+
+    // index into differences, or -1
+    int expected_difference(const char* v, check c) {
+        for (size_t i = 0; i < difference_count; ++i)
+            if (differences[i].site == c && strcmp(differences[i].variant, v) == 0) return static_cast<int>(i);
+        return -1;
+    }
+
+    // ---- before: the pre-image_view code, on raw offsets ----
+
+    namespace before {
+        bool rva_in_bounds(uint32_t rva, uint64_t size, uint32_t limit) {
+            return rva < limit && rva + size <= limit;
+        }
+
+        // imports::detail::validate_pe_header
+        bool validate_pe_header(const uint8_t* base, uint32_t& nt_at, uint32_t& size) {
+            if (get<uint16_t>(base) != 0x5A4D) return false;
+            int32_t lfanew = get<int32_t>(base + 0x3C);
+            if (lfanew <= 0 || lfanew >= 0x1000) return false;
+            if (get<uint32_t>(base + lfanew) != 0x4550) return false;
+            size = get<uint32_t>(base + lfanew + 24 + 56);
+            if (size == 0 || size > 0x7FFFFFFF) return false;
+            nt_at = static_cast<uint32_t>(lfanew);
+            return true;
+        }
+
+        struct export_dir {
+            uint32_t va, size, names, ordinals, functions, name_count, function_count;
+        };
+
+        export_dir read_dir(const uint8_t* base, uint32_t nt_at) {
+            export_dir d{};
+            d.va = get<uint32_t>(base + nt_at + 24 + 112);
+            d.size = get<uint32_t>(base + nt_at + 24 + 116);
+            return d;
+        }
+
+        void read_tables(const uint8_t* base, export_dir& d) {
+            const uint8_t* dir = base + d.va;
+            d.function_count = get<uint32_t>(dir + 20);
+            d.name_count = get<uint32_t>(dir + 24);
+            d.functions = get<uint32_t>(dir + 28);
+            d.names = get<uint32_t>(dir + 32);
+            d.ordinals = get<uint32_t>(dir + 36);
+        }
+
+        // found, and whether the rva is a forwarder string
+        struct lookup {
+            bool found = false;
+            bool forwarded = false;
+            uint32_t rva = 0;
+            bool operator==(const lookup&) const = default;
+        };
+
+        // imports::walkExportTable, user mode
+        lookup walk(const uint8_t* base, uint32_t h) {
+            uint32_t nt_at, size;
+            if (!validate_pe_header(base, nt_at, size)) return {};
+            export_dir d = read_dir(base, nt_at);
+            if (d.va == 0 || d.size == 0) return {};
+            if (!rva_in_bounds(d.va, d.size, size)) return {};
+            read_tables(base, d);
+            if (!rva_in_bounds(d.names, d.name_count * uint64_t{4}, size)) return {};
+            if (!rva_in_bounds(d.ordinals, d.name_count * uint64_t{2}, size)) return {};
+            if (!rva_in_bounds(d.functions, d.function_count * uint64_t{4}, size)) return {};
+            for (uint32_t i = 0; i < d.name_count; ++i) {
+                uint32_t name = get<uint32_t>(base + d.names + i * 4);
+                if (!rva_in_bounds(name, 1, size)) continue;
+                if (hash::fnv1a_runtime_bounded(reinterpret_cast<const char*>(base + name), size - name) != h) continue;
+                uint16_t ordinal = get<uint16_t>(base + d.ordinals + i * 2);
+                if (ordinal >= d.function_count) return {};
+                uint32_t rva = get<uint32_t>(base + d.functions + ordinal * 4);
+                bool fwd = uint64_t{rva} >= d.va && uint64_t{rva} < uint64_t{d.va} + d.size;
+                return { true, fwd, rva };
+            }
+            return {};
+        }
+
+        // imports::detail::resolve_forwarded_export, after the PEB walk
+        lookup forward_tail(const uint8_t* base, uint32_t h) {
+            uint32_t nt_at, size;
+            if (!validate_pe_header(base, nt_at, size)) return {};
+            export_dir d = read_dir(base, nt_at);
+            if (d.va == 0) return {};
+            if (!rva_in_bounds(d.va, d.size, size)) return {};
+            read_tables(base, d);
+            // 32-bit products, as the old code computed them
+            if (!rva_in_bounds(d.names, uint32_t(d.name_count * 4), size)) return {};
+            if (!rva_in_bounds(d.ordinals, uint32_t(d.name_count * 2), size)) return {};
+            if (!rva_in_bounds(d.functions, uint32_t(d.function_count * 4), size)) return {};
+            for (uint32_t i = 0; i < d.name_count; ++i) {
+                uint32_t name = get<uint32_t>(base + d.names + i * 4);
+                if (!rva_in_bounds(name, 1, size)) continue;
+                if (hash::fnv1a_runtime_bounded(reinterpret_cast<const char*>(base + name), size - name) != h) continue;
+                uint16_t ordinal = get<uint16_t>(base + d.ordinals + i * 2);
+                if (ordinal >= d.function_count) return {};
+                return { true, false, get<uint32_t>(base + d.functions + ordinal * 4) };
+            }
+            return {};
+        }
+
+        // anti_debug::detail::get_proc_by_hash: header checks, then no bounds at all
+        lookup get_proc(const uint8_t* base, uint32_t h) {
+            uint32_t nt_at, size;
+            if (!validate_pe_header(base, nt_at, size)) return {};
+            export_dir d = read_dir(base, nt_at);
+            if (d.va == 0 || d.size == 0) return {};
+            read_tables(base, d);
+            for (uint32_t i = 0; i < d.name_count; ++i) {
+                auto name = reinterpret_cast<const char*>(base + get<uint32_t>(base + d.names + i * 4));
+                if (hash::fnv1a_runtime(std::string_view(name)) != h) continue;
+                uint16_t ordinal = get<uint16_t>(base + d.ordinals + i * 2);
+                if (ordinal >= d.function_count) return {};
+                return { true, false, get<uint32_t>(base + d.functions + ordinal * 4) };
+            }
+            return {};
+        }
+
+        // pe::resolve_exports and export_index::build read the tables through
+        // image_view already; both skipped bad ordinals and zero rvas
+        std::map<uint32_t, uint32_t> table(const uint8_t* base) {
+            std::map<uint32_t, uint32_t> out;
+            pe::image_view img;
+            if (!img.parse_module(base) || img.export_rva() == 0) return out;
+            const uint8_t* dir = img.at(img.export_rva(), 40);
+            if (!dir) return out;
+            uint32_t functions_n = get<uint32_t>(dir + 20), names_n = get<uint32_t>(dir + 24);
+            const uint8_t* functions = img.at(get<uint32_t>(dir + 28), functions_n * size_t{4});
+            const uint8_t* names = img.at(get<uint32_t>(dir + 32), names_n * size_t{4});
+            const uint8_t* ordinals = img.at(get<uint32_t>(dir + 36), names_n * size_t{2});
+            if (!functions || !names || !ordinals) return out;
+            for (uint32_t i = 0; i < names_n; ++i) {
+                uint32_t name_rva = get<uint32_t>(names + i * 4);
+                auto name = reinterpret_cast<const char*>(img.at(name_rva, 1));
+                if (!name) continue;
+                uint16_t ordinal = get<uint16_t>(ordinals + i * 2);
+                if (ordinal >= functions_n) continue;
+                uint32_t rva = get<uint32_t>(functions + ordinal * 4);
+                if (rva) out.emplace(hash::fnv1a_runtime_bounded(name, img.available(name_rva)), rva);
+            }
+            return out;
+        }
+
+        // findSyscallGadget / findRetGadget / findJmpRbxGadget
+        uint32_t scan(const uint8_t* base, const uint8_t* pattern, uint32_t len) {
+            uint32_t nt_at, size;
+            if (!validate_pe_header(base, nt_at, size)) return 0;
+            uint16_t count = get<uint16_t>(base + nt_at + 6);
+            uint32_t sh = nt_at + 24 + get<uint16_t>(base + nt_at + 20);
+            for (uint16_t i = 0; i < count; ++i, sh += 40) {
+                if (!(get<uint32_t>(base + sh + 36) & 0x20000000)) continue;
+                uint32_t start = get<uint32_t>(base + sh + 12);
+                uint32_t vsize = get<uint32_t>(base + sh + 8);
+                if (!rva_in_bounds(start, vsize, size)) continue;
+                for (uint32_t j = 0; j + len - 1 < vsize; ++j)
+                    if (memcmp(base + start + j, pattern, len) == 0) return start + j;
+            }
+            return 0;
+        }
+    }
+
+    // ---- after: what each site does now ----
+
+    namespace after {
+        using before::lookup;
+
+        // walkExportTable: the index first, the linear scan as fallback. both
+        // have to agree, since either can serve a lookup
+        lookup walk(const uint8_t* base, uint32_t h) {
+            pe::image_view img;
+            if (!img.parse_module(base)) return {};
+            uint32_t scanned = pe::find_export(img, h);
+            pe::export_index index;
+            if (index.build(img)) CW_CHECK(index.find(h) == scanned);
+            if (!scanned) return {};
+            return { true, img.in_export_directory(scanned), scanned };
+        }
+
+        // resolve_forwarded_export and get_proc_by_hash: the rva, or nothing
+        lookup find(const uint8_t* base, uint32_t h) {
+            pe::image_view img;
+            if (!img.parse_module(base)) return {};
+            uint32_t rva = pe::find_export(img, h);
+            if (!rva) return {};
+            return { true, false, rva };
+        }
+
+        std::map<uint32_t, uint32_t> table(const uint8_t* base) {
+            std::map<uint32_t, uint32_t> out;
+            pe::image_view img;
+            if (!img.parse_module(base)) return out;
+            for (const pe::export_symbol& sym : img.exports())
+                if (sym.name && sym.rva)
+                    out.emplace(hash::fnv1a_runtime_bounded(sym.name, sym.name_max), sym.rva);
+            return out;
+        }
+
+        uint32_t scan(const uint8_t* base, const uint8_t* pattern, uint32_t len) {
+            pe::image_view img;
+            if (!img.parse_module(base)) return 0;
+            for (const pe::section& sec : img.sections()) {
+                if (!sec.executable()) continue;
+                const uint8_t* text = img.at(sec.virtual_address, sec.virtual_size);
+                if (!text) continue;
+                for (uint32_t j = 0; j + len - 1 < sec.virtual_size; ++j)
+                    if (memcmp(text + j, pattern, len) == 0) return sec.virtual_address + j;
+            }
+            return 0;
+        }
+    }
+
+    // CW_IMPORT_SET's name set; its result has to match the per-name table
+    constexpr pe::export_names<5> set_names{ {
+        hash::fnv1a("NtClose"), hash::fnv1a("NtOpenFile"), hash::fnv1a("RtlForwarded"),
+        hash::fnv1a("BadOrdinal"), hash::fnv1a("Missing"),
+    } };
+    constexpr auto wanted = pe::export_name_positions(set_names);
+
+    int failures = 0;
+
+    template<typename T>
+    void compare(const char* v, check c, const T& old_result, const T& new_result) {
+        if (int d = expected_difference(v, c); d >= 0) {
+            observed[d] |= !(old_result == new_result);
+            return;
+        }
+        if (old_result == new_result) return;
+        std::fprintf(stderr, "%s: %s differs from the old code\n", v, check_names[c]);
+        ++failures;
+    }
+}
+
+int main() {
+    const uint8_t syscall_ret[] = { 0x0F, 0x05, 0xC3 };
+    const uint8_t ret[] = { 0xC3 };
+    const uint8_t jmp_rbx[] = { 0xFF, 0xE3 };
+
+    // the well-formed image resolves what it should, so agreeing means something
+    {
+        std::vector<uint8_t> img = make_image();
+        CW_CHECK(before::walk(img.data(), hash::fnv1a("NtClose")).rva == text_va + 0x10);
+        CW_CHECK(before::walk(img.data(), hash::fnv1a("RtlForwarded")).forwarded);
+        CW_CHECK(before::scan(img.data(), syscall_ret, 3) == text_va + 0x43);
+        CW_CHECK(before::scan(img.data(), jmp_rbx, 2) == text_va + 0x40);
+    }
+
+    for (const variant& v : variants) {
+        std::vector<uint8_t> img = make_image();
+        v.damage(img);
+        const uint8_t* base = img.data();
+
+        uint32_t nt_at, size;
+        pe::image_view view;
+        compare(v.name, header, before::validate_pe_header(base, nt_at, size), view.parse_module(base));
+
+        for (const char* name : probes) {
+            uint32_t h = hash::fnv1a_runtime_bounded(name, strlen(name));
+            compare(v.name, walk, before::walk(base, h), after::walk(base, h));
+            compare(v.name, forward_tail, before::forward_tail(base, h), after::find(base, h));
+            compare(v.name, get_proc, before::get_proc(base, h), after::find(base, h));
+        }
+
+        auto old_table = before::table(base);
+        compare(v.name, export_index, old_table, after::table(base));
+
+        // CW_IMPORT_SET: each wanted name gets what the per-name table has
+        pe::image_view set_view;
+        uint32_t rvas[5];
+        size_t found = set_view.parse_module(base) ? pe::resolve_exports(set_view, wanted, rvas) : 0;
+        if (!set_view.valid()) for (auto& r : rvas) r = 0;
+        std::vector<uint32_t> old_set, new_set(rvas, rvas + 5);
+        size_t old_found = 0;
+        for (uint32_t wanted_hash : set_names.hashes) {
+            auto it = old_table.find(wanted_hash);
+            old_set.push_back(it == old_table.end() ? 0 : it->second);
+            old_found += it != old_table.end();
+        }
+        compare(v.name, import_set, old_set, new_set);
+        compare(v.name, import_set, old_found, found);
+
+        compare(v.name, scan_syscall, before::scan(base, syscall_ret, 3), after::scan(base, syscall_ret, 3));
+        compare(v.name, scan_ret, before::scan(base, ret, 1), after::scan(base, ret, 1));
+        compare(v.name, scan_jmp_rbx, before::scan(base, jmp_rbx, 2), after::scan(base, jmp_rbx, 2));
+    }
+
+    // every listed difference still is one; a stale entry would hide a regression
+    for (size_t i = 0; i < difference_count; ++i) {
+        if (observed[i]) continue;
+        std::fprintf(stderr, "%s: %s no longer differs\n", differences[i].variant, check_names[differences[i].site]);
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// string site registry: predecrypt_all() has to find sites inside function
+// templates and class template members (gcc drops section attributes there),
+// and a site that only predecrypt_all() ever decrypted still has to be wiped.
+//
+// none of the sites below is called before predecrypt_all().
+
+#include "cloakwork.h"
+#include "cw_test.h"
+
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+    template<int I>
+    const char* template_site() { return CW_STR("registry: template site"); }
+
+    template<typename T>
+    struct holder {
+        static const char* member_site() { return CW_STR("registry: member site"); }
+    };
+
+    template<int I>
+    const wchar_t* wide_template_site() { return CW_WSTR(L"registry: wide site"); }
+
+    template<int I>
+    const char* shared_template_site() { return CW_STR_SHARED("registry: shared site"); }
+
+    const char* plain_site() { return CW_STR("registry: plain site"); }
+
+    // each site must be instantiated, but never reached before predecrypt_all()
+    volatile bool call_sites = false;
+
+#if CW_ENABLE_STRING_ENCRYPTION
+    // the secret only ever decrypted by predecrypt_all(), looked up in the arena
+    constexpr std::string_view secret = "registry: template site";
+
+    const char* arena_begin = nullptr;
+    const char* arena_end = nullptr;
+
+    bool arena_holds_secret() {
+        for (const char* p = arena_begin; p + secret.size() <= arena_end; ++p)
+            if (memcmp(p, secret.data(), secret.size()) == 0) return true;
+        return false;
+    }
+#endif
+}
+
+int main() {
+    if (call_sites) {
+        template_site<1>();
+        holder<int>::member_site();
+        wide_template_site<2>();
+        shared_template_site<3>();
+        plain_site();
+    }
+
+#if CW_ENABLE_STRING_ENCRYPTION
+  #if !CW_TRIVIAL_STRINGS
+    // registered before any site's destructor, so it runs after all of them
+    std::atexit([] {
+        if (arena_holds_secret()) {
+            std::fprintf(stderr, "predecrypted site was not wiped at exit\n");
+            std::_Exit(1);
+        }
+    });
+  #endif
+
+    CW_CHECK(cloakwork::string_encrypt::predecrypt_all(2) == 5);
+
+    auto& arena = cloakwork::string_encrypt::detail::arena();
+    arena_end = arena.cur;
+    arena_begin = arena.cur - (CW_STR_ARENA_CHUNK - arena.left);
+    CW_CHECK(arena_holds_secret());
+
+  #if CW_TRIVIAL_STRINGS
+    // the wide site keeps its plaintext in the object, so it is on the list too
+    CW_CHECK(cloakwork::wipe_all() == 5);
+    CW_CHECK(!arena_holds_secret());
+  #endif
+
+    // sites still work afterwards
+    CW_CHECK(std::string_view(template_site<1>()) == secret);
+    CW_CHECK(std::wstring_view(wide_template_site<2>()) == L"registry: wide site");
+#else
+    CW_CHECK(cloakwork::string_encrypt::predecrypt_all(2) == 0);
+    CW_CHECK(std::string_view(template_site<1>()) == "registry: template site");
+#endif
+    return 0;
+}
@@ -0,0 +1,54 @@
+// cw_logdecode - turns a CW_LOG stream (the bytes cloakwork::logging::drain
+// handed to its sink) back into text.
+//
+// usage: cw_logdecode --key <CW_LOG_KEY> [file]
+//
+// reads stdin when no file is given. the key is the CW_LOG_KEY the logging
+// binary was built with; there is no default.
+
+#define CW_LOG_DECODER
+#include "cloakwork.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+int main(int argc, char** argv) {
+    uint64_t key = 0;
+    bool have_key = false;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--key") && i + 1 < argc) {
+            key = strtoull(argv[++i], nullptr, 0);
+            have_key = true;
+        } else if (argv[i][0] == '-' && argv[i][1]) {
+            have_key = false;
+            break;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!have_key) {
+        fprintf(stderr, "usage: %s --key <CW_LOG_KEY> [file]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* f = path && strcmp(path, "-") ? fopen(path, "rb") : stdin;
+    if (!f) {
+        fprintf(stderr, "cw_logdecode: cannot open %s\n", path);
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        data.insert(data.end(), buf, buf + n);
+    if (f != stdin) fclose(f);
+
+    for (const auto& line : cloakwork::logging::decode(data.data(), data.size(), key))
+        puts(line.c_str());
+    return 0;
+}
@@ -0,0 +1,134 @@
+// cw_pedump - lists the sections and named exports of a PE file through
+// cloakwork::pe::image_view, with the fnv1a hash CW_IMPORT would look each
+// export up by. handy for checking a hash against a DLL off the target box.
+//
+// usage: cw_pedump [--mapped] <file>
+//
+// the file is read as it sits on disk unless --mapped says it is a memory
+// dump of a loaded module.
+
+#include "cloakwork.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CW_PEDUMP_MMAP 1
+#else
+#define CW_PEDUMP_MMAP 0
+#endif
+
+namespace {
+
+    struct file_bytes {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        std::vector<uint8_t> copy;
+
+        bool open(const char* path) {
+#if CW_PEDUMP_MMAP
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    data = static_cast<const uint8_t*>(p);
+                    size = static_cast<size_t>(st.st_size);
+                }
+            }
+            close(fd);
+            if (data) return true;
+#endif
+            FILE* f = fopen(path, "rb");
+            if (!f) return false;
+            uint8_t buf[65536];
+            size_t n;
+            while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+                copy.insert(copy.end(), buf, buf + n);
+            fclose(f);
+            data = copy.data();
+            size = copy.size();
+            return true;
+        }
+    };
+
+    // prints a name read out of the image, stopping at the first NUL or at max
+    void print_name(const char* name, size_t max, size_t width) {
+        size_t n = 0;
+        while (n < max && name[n]) ++n;
+        printf("%-*.*s", static_cast<int>(width), static_cast<int>(n), name);
+    }
+}
+
+int main(int argc, char** argv) {
+    auto kind = cloakwork::pe::layout::file;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--mapped")) {
+            kind = cloakwork::pe::layout::mapped;
+        } else if (argv[i][0] == '-' || path) {
+            fprintf(stderr, "usage: %s [--mapped] <file>\n", argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [--mapped] <file>\n", argv[0]);
+        return 2;
+    }
+
+    file_bytes bytes;
+    if (!bytes.open(path)) {
+        fprintf(stderr, "cw_pedump: cannot open %s\n", path);
+        return 1;
+    }
+
+    cloakwork::pe::image_view img;
+    if (!img.parse(bytes.data, bytes.size, kind)) {
+        fprintf(stderr, "cw_pedump: %s is not a PE image\n", path);
+        return 1;
+    }
+
+    printf("image size 0x%08x, %u sections\n\n", img.image_size(), img.sections().size());
+    printf("%-8s  %-10s  %-10s  %-10s  %-10s  %s\n", "name", "va", "vsize", "raw", "rawsize", "flags");
+    for (const cloakwork::pe::section& sec : img.sections()) {
+        print_name(sec.name, 8, 8);
+        printf("  0x%08x  0x%08x  0x%08x  0x%08x  0x%08x%s\n", sec.virtual_address, sec.virtual_size,
+               sec.raw_pointer, sec.raw_size, sec.characteristics, sec.executable() ? " x" : "");
+    }
+
+    cloakwork::pe::export_range exports = img.exports();
+    if (!exports.valid()) {
+        puts("\nno export directory");
+        return 0;
+    }
+
+    printf("\n%u named exports of %u functions\n\n", exports.size(), exports.function_count());
+    printf("%-10s  %-10s  %-7s  %s\n", "hash", "rva", "ordinal", "name");
+    for (const cloakwork::pe::export_symbol& sym : exports) {
+        if (!sym.name) {
+            printf("%-10s  0x%08x  %7u  <name out of bounds>\n", "-", sym.rva, sym.ordinal);
+            continue;
+        }
+        printf("0x%08x  0x%08x  %7u  ", cloakwork::hash::fnv1a_runtime_bounded(sym.name, sym.name_max),
+               sym.rva, sym.ordinal);
+        print_name(sym.name, sym.name_max, 0);
+        if (sym.forwarded) {
+            const char* target = reinterpret_cast<const char*>(img.at(sym.rva, 1));
+            if (target) {
+                fputs(" -> ", stdout);
+                print_name(target, img.available(sym.rva), 0);
+            }
+        }
+        putchar('\n');
+    }
+    return 0;
+}